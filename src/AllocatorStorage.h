@@ -0,0 +1,57 @@
+#ifndef AISDI_LINEAR_ALLOCATORSTORAGE_H
+#define AISDI_LINEAR_ALLOCATORSTORAGE_H
+
+#include <memory>
+#include <type_traits>
+
+namespace aisdi
+{
+
+// Private base of every container holding its allocator. An empty
+// allocator such as std::allocator becomes a base in turn, so like
+// InlineStorage<Type, 0> it adds nothing to the size of the container.
+template <typename Allocator,
+          bool Empty = std::is_empty<Allocator>::value && !std::is_final<Allocator>::value>
+class AllocatorStorage
+{
+  Allocator allocator;
+
+protected:
+  explicit AllocatorStorage(const Allocator& alloc) : allocator(alloc)
+  {}
+
+  Allocator& storedAllocator()
+  {
+    return allocator;
+  }
+
+  const Allocator& storedAllocator() const
+  {
+    return allocator;
+  }
+};
+
+template <typename Allocator>
+class AllocatorStorage<Allocator, true> : private Allocator
+{
+protected:
+  explicit AllocatorStorage(const Allocator& alloc) : Allocator(alloc)
+  {}
+
+  Allocator& storedAllocator()
+  {
+    return *this;
+  }
+
+  const Allocator& storedAllocator() const
+  {
+    return *this;
+  }
+};
+
+template <typename Allocator, typename Type>
+using ReboundAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Type>;
+
+}
+
+#endif // AISDI_LINEAR_ALLOCATORSTORAGE_H
@@ -0,0 +1,304 @@
+#ifndef AISDI_LINEAR_BENCHMARK_H
+#define AISDI_LINEAR_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "Vector.h"
+
+namespace aisdi
+{
+
+namespace benchmark
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Makes the compiler assume value is read, so the work producing it is
+// not optimised away.
+template <typename Type>
+inline void keep(const Type& value)
+{
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static const volatile void *sink;
+  sink = &value;
+#endif
+}
+
+// Bytes currently held through CountingAllocator and the most held at
+// once since the last resetPeak(). Not thread safe, benchmarks run on one
+// thread.
+class AllocationCounter
+{
+  static std::size_t& current()
+  {
+    static std::size_t bytes = 0;
+    return bytes;
+  }
+
+  static std::size_t& peak()
+  {
+    static std::size_t bytes = 0;
+    return bytes;
+  }
+
+public:
+
+  static void allocated(std::size_t bytes)
+  {
+    current() += bytes;
+    peak() = std::max(peak(), current());
+  }
+
+  static void deallocated(std::size_t bytes)
+  {
+    current() -= bytes;
+  }
+
+  static void resetPeak()
+  {
+    peak() = current();
+  }
+
+  static std::size_t getCurrent()
+  {
+    return current();
+  }
+
+  static std::size_t getPeak()
+  {
+    return peak();
+  }
+};
+
+// std::allocator that reports every allocation to AllocationCounter. Only
+// the container's own storage is counted, not what the elements allocate.
+template <typename Type>
+class CountingAllocator
+{
+public:
+  using value_type = Type;
+
+  CountingAllocator() = default;
+
+  template <typename Other>
+  CountingAllocator(const CountingAllocator<Other>&)
+  {}
+
+  Type* allocate(std::size_t count)
+  {
+    Type *storage = std::allocator<Type>().allocate(count);
+    AllocationCounter::allocated(count * sizeof(Type));
+    return storage;
+  }
+
+  void deallocate(Type *storage, std::size_t count)
+  {
+    AllocationCounter::deallocated(count * sizeof(Type));
+    std::allocator<Type>().deallocate(storage, count);
+  }
+
+  template <typename Other>
+  bool operator==(const CountingAllocator<Other>&) const
+  {
+    return true;
+  }
+
+  template <typename Other>
+  bool operator!=(const CountingAllocator<Other>&) const
+  {
+    return false;
+  }
+};
+
+struct Config
+{
+  std::size_t warmup = 1;
+  std::size_t repetitions = 5;
+};
+
+// Timings are in nanoseconds for one whole run, work is the number of
+// element operations a run performs. peakBytes is left to the caller to
+// measure, relative is the baseline's median over this one's, so above 1
+// means faster than the baseline.
+struct Result
+{
+  std::string container;
+  std::string element;
+  std::string operation;
+  std::size_t size;
+  std::size_t work;
+  std::size_t repetitions;
+  double min;
+  double median;
+  double p99;
+  double mean;
+  std::size_t peakBytes;
+  std::string baseline;
+  double relative;
+};
+
+class Suite
+{
+  Config config;
+  Vector<Result> results;
+
+  static double percentile(const Vector<double>& sorted, double fraction)
+  {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * sorted.getSize()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+  }
+
+  static double median(const Vector<double>& sorted)
+  {
+    std::size_t middle = sorted.getSize() / 2;
+
+    if (sorted.getSize() % 2 != 0)
+      return sorted[middle];
+    return (sorted[middle - 1] + sorted[middle]) / 2;
+  }
+
+  static void writeJsonString(std::ostream& out, const std::string& text)
+  {
+    out << '"';
+    for (char c : text)
+    {
+      if (c == '"' || c == '\\')
+        out << '\\';
+      out << c;
+    }
+    out << '"';
+  }
+
+public:
+
+  explicit Suite(const Config& benchmarkConfig = Config()) : config(benchmarkConfig)
+  {
+    if (config.repetitions == 0)
+      config.repetitions = 1;
+  }
+
+  // Calls setup() for a fresh state before every run and times only
+  // body(state). The state is destroyed after the clock has stopped.
+  template <typename Setup, typename Body>
+  Result& run(const std::string& container, const std::string& element, const std::string& operation,
+              std::size_t size, std::size_t work, Setup setup, Body body)
+  {
+    Vector<double> samples;
+    samples.reserve(config.repetitions);
+
+    for (std::size_t i = 0; i < config.warmup + config.repetitions; ++i)
+    {
+      auto state = setup();
+
+      Clock::time_point start = Clock::now();
+      body(state);
+      Clock::time_point end = Clock::now();
+
+      keep(state);
+      if (i >= config.warmup)
+        samples.append(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    return record(container, element, operation, size, work, std::move(samples));
+  }
+
+  // Adds a result made of samples in nanoseconds taken by the caller, such
+  // as one per element rather than one per run. repetitions is then the
+  // number of samples.
+  Result& record(const std::string& container, const std::string& element, const std::string& operation,
+                 std::size_t size, std::size_t work, Vector<double> samples)
+  {
+    if (samples.isEmpty())
+      samples.append(0);
+
+    std::sort(samples.begin(), samples.end());
+
+    double total = 0;
+    for (double sample : samples)
+      total += sample;
+
+    results.append(Result{container, element, operation, size, work, samples.getSize(),
+                          samples[0], median(samples), percentile(samples, 0.99), total / samples.getSize(),
+                          0, std::string(), 0});
+    return results[results.getSize() - 1];
+  }
+
+  // Compares every result of container with the baseline's result for the
+  // same element, operation and size.
+  void relateTo(const std::string& container, const std::string& baseline)
+  {
+    for (Result& result : results)
+    {
+      if (result.container != container)
+        continue;
+
+      for (const Result& other : results)
+        if (other.container == baseline && other.element == result.element
+            && other.operation == result.operation && other.size == result.size)
+        {
+          result.baseline = baseline;
+          result.relative = other.median / result.median;
+          break;
+        }
+    }
+  }
+
+  const Vector<Result>& getResults() const
+  {
+    return results;
+  }
+
+  void writeCsv(std::ostream& out) const
+  {
+    out << "container,element,operation,size,work,repetitions,min_ns,median_ns,p99_ns,mean_ns,median_ns_per_item,peak_bytes,baseline,relative\n";
+
+    for (const Result& result : results)
+      out << result.container << ',' << result.element << ',' << result.operation << ','
+          << result.size << ',' << result.work << ',' << result.repetitions << ','
+          << result.min << ',' << result.median << ',' << result.p99 << ',' << result.mean << ','
+          << result.median / (result.work != 0 ? result.work : 1) << ','
+          << result.peakBytes << ',' << result.baseline << ',' << result.relative << '\n';
+  }
+
+  void writeJson(std::ostream& out) const
+  {
+    out << "[\n";
+
+    for (std::size_t i = 0; i < results.getSize(); ++i)
+    {
+      const Result& result = results[i];
+
+      out << "  {\"container\": ";
+      writeJsonString(out, result.container);
+      out << ", \"element\": ";
+      writeJsonString(out, result.element);
+      out << ", \"operation\": ";
+      writeJsonString(out, result.operation);
+      out << ", \"size\": " << result.size << ", \"work\": " << result.work
+          << ", \"repetitions\": " << result.repetitions
+          << ", \"min_ns\": " << result.min << ", \"median_ns\": " << result.median
+          << ", \"p99_ns\": " << result.p99 << ", \"mean_ns\": " << result.mean
+          << ", \"peak_bytes\": " << result.peakBytes << ", \"baseline\": ";
+      writeJsonString(out, result.baseline);
+      out << ", \"relative\": " << result.relative << "}"
+          << (i + 1 < results.getSize() ? ",\n" : "\n");
+    }
+
+    out << "]\n";
+  }
+};
+
+}
+
+}
+
+#endif // AISDI_LINEAR_BENCHMARK_H
@@ -0,0 +1,694 @@
+#ifndef AISDI_LINEAR_COMPACTLIST_H
+#define AISDI_LINEAR_COMPACTLIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "AllocatorStorage.h"
+#include "Statistics.h"
+#include "Vector.h"
+
+// Unless AISDI_CHECKED_ITERATORS is 0 (the NDEBUG default) iterators throw
+// std::out_of_range when they step or dereference outside the list.
+#ifndef AISDI_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define AISDI_CHECKED_ITERATORS 0
+#else
+#define AISDI_CHECKED_ITERATORS 1
+#endif
+#endif
+
+namespace aisdi
+{
+
+namespace detail
+{
+
+template <typename Type, typename Index>
+struct CompactListNode
+{
+  Index prev;
+  Index next;
+  typename std::aligned_storage<sizeof(Type), alignof(Type)>::type storage;
+  Type* valuePtr() {return reinterpret_cast<Type*>(&storage);}
+};
+
+}
+
+// LinkedList for large numbers of small elements. Links are Index wide
+// positions in a node pool instead of pointers, so with the default 32-bit
+// Index a node of int takes 12 bytes where a LinkedList node takes 24.
+// The pool is made of fixed chunks of CHUNK_NODES nodes that never move,
+// growing it only appends to the chunk table. Node 0 is the sentinel and
+// freed nodes are kept for reuse until the list is destroyed. At most
+// std::numeric_limits<Index>::max() elements fit. An iterator is the
+// address of its list plus an index, so unlike LinkedList's it does not
+// follow its element through swap or a move.
+template <typename Type, typename Allocator = std::allocator<Type>, typename Index = std::uint32_t>
+class CompactList : private AllocatorStorage<ReboundAllocator<Allocator, detail::CompactListNode<Type, Index>>>, private Statistics
+{
+  static_assert(std::is_unsigned<Index>::value, "Index must be an unsigned integer type");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using allocator_type = Allocator;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  using Node = detail::CompactListNode<Type, Index>;
+
+private:
+  using NodeAllocator = ReboundAllocator<Allocator, Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  static_assert(std::is_same<typename NodeTraits::pointer, Node*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  NodeAllocator& nodeAllocator()
+  {
+    return this->storedAllocator();
+  }
+
+  const NodeAllocator& nodeAllocator() const
+  {
+    return this->storedAllocator();
+  }
+
+  static const size_type CHUNK_BITS = 10;
+  static const size_type CHUNK_NODES = size_type(1) << CHUNK_BITS;
+  static const Index SENTINEL = 0;
+
+  size_type length;
+  size_type poolSize;
+  Index freeNodes;
+  // Last, so that the empty bases it shares with this list do not need
+  // padding to get an address of their own.
+  Vector<Node*> chunks;
+
+  Node& node(Index index) const
+  {
+    return chunks.data()[index >> CHUNK_BITS][index & (CHUNK_NODES - 1)];
+  }
+
+  void addChunk()
+  {
+    Node *chunk = NodeTraits::allocate(nodeAllocator(), CHUNK_NODES);
+
+    try
+    {
+      chunks.append(chunk);
+    }
+    catch (...)
+    {
+      NodeTraits::deallocate(nodeAllocator(), chunk, CHUNK_NODES);
+      throw;
+    }
+
+    countAllocation(CHUNK_NODES * sizeof(Node));
+    countCapacity(chunks.getSize() * CHUNK_NODES);
+  }
+
+  // The sentinel is only allocated with the first element.
+  void ensureSentinel()
+  {
+    if (!chunks.isEmpty())
+      return;
+
+    addChunk();
+    ::new (static_cast<void*>(&node(SENTINEL))) Node;
+    node(SENTINEL).prev = node(SENTINEL).next = SENTINEL;
+    poolSize = 1;
+  }
+
+  Index acquireNode()
+  {
+    ensureSentinel();
+
+    Index index = freeNodes;
+
+    if (index != SENTINEL)
+      freeNodes = node(index).next;
+    else
+    {
+      if (poolSize > std::numeric_limits<Index>::max())
+        throw std::length_error("CompactList cannot hold more elements.");
+
+      if (poolSize == chunks.getSize() * CHUNK_NODES)
+        addChunk();
+
+      index = static_cast<Index>(poolSize++);
+    }
+
+    ::new (static_cast<void*>(&node(index))) Node;
+    countNodeAllocation();
+    return index;
+  }
+
+  void recycleNode(Index index)
+  {
+    node(index).next = freeNodes;
+    freeNodes = index;
+    countNodeFrees(1);
+  }
+
+  template <typename... Args>
+  Index createNode(Args&&... args)
+  {
+    Index index = acquireNode();
+
+    try
+    {
+      NodeTraits::construct(nodeAllocator(), node(index).valuePtr(), std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      recycleNode(index);
+      throw;
+    }
+
+    return index;
+  }
+
+  void linkBefore(Index position, Index index)
+  {
+    Node& inserted = node(index);
+    Node& next = node(position);
+
+    inserted.prev = next.prev;
+    inserted.next = position;
+    node(next.prev).next = index;
+    next.prev = index;
+
+    ++length;
+  }
+
+  // Destroys the payloads and hands every chunk back.
+  void dispose()
+  {
+    if (chunks.isEmpty())
+      return;
+
+    for (Index index = node(SENTINEL).next; index != SENTINEL; index = node(index).next)
+      NodeTraits::destroy(nodeAllocator(), node(index).valuePtr());
+    countNodeFrees(length);
+
+    for (Node *chunk : chunks)
+    {
+      NodeTraits::deallocate(nodeAllocator(), chunk, CHUNK_NODES);
+      countDeallocation();
+    }
+
+    chunks.clear();
+    length = 0;
+    poolSize = 0;
+    freeNodes = SENTINEL;
+  }
+
+  // Takes over other's pool, this list must own none.
+  void steal(CompactList& other)
+  {
+    using std::swap;
+
+    swap(chunks, other.chunks);
+    swap(length, other.length);
+    swap(poolSize, other.poolSize);
+    swap(freeNodes, other.freeNodes);
+  }
+
+  void moveAssign(CompactList& other, std::true_type)
+  {
+    dispose();
+    nodeAllocator() = other.nodeAllocator();
+    steal(other);
+  }
+
+  // Allocators that do not propagate can only exchange pools when equal.
+  void moveAssign(CompactList& other, std::false_type)
+  {
+    dispose();
+
+    if (nodeAllocator() == other.nodeAllocator())
+    {
+      steal(other);
+      return;
+    }
+
+    for (auto it = other.begin(); it != other.end(); ++it)
+      append(std::move(*it));
+    other.clear();
+  }
+
+  void swapAllocators(CompactList& other, std::true_type)
+  {
+    using std::swap;
+    swap(nodeAllocator(), other.nodeAllocator());
+  }
+
+  void swapAllocators(CompactList&, std::false_type)
+  {}
+
+public:
+
+  CompactList(): CompactList(allocator_type())
+  {}
+
+  explicit CompactList(const allocator_type& alloc)
+    : AllocatorStorage<NodeAllocator>(alloc), length(0), poolSize(0), freeNodes(SENTINEL), chunks()
+  {}
+
+  CompactList(std::initializer_list<Type> l, const allocator_type& alloc = allocator_type()):CompactList(alloc)
+  {
+    for (auto it = l.begin(); it != l.end(); ++it)
+      append(*it);
+  }
+
+  CompactList(const CompactList& other)
+    :CompactList(allocator_type(NodeTraits::select_on_container_copy_construction(other.nodeAllocator())))
+  {
+    for (auto it = other.begin(); it != other.end(); ++it)
+      append(*it);
+  }
+
+  // Takes over other's nodes. Iterators into other are invalidated, they
+  // keep pointing at other.
+  CompactList(CompactList&& other):CompactList(allocator_type(other.nodeAllocator()))
+  {
+    steal(other);
+  }
+
+  ~CompactList()
+  {
+    dispose();
+  }
+
+  CompactList& operator=(const CompactList& other)
+  {
+    if (this == &other)
+      return *this;
+
+    clear();
+    if (NodeTraits::propagate_on_container_copy_assignment::value
+        && nodeAllocator() != other.nodeAllocator())
+    {
+      dispose();
+      nodeAllocator() = other.nodeAllocator();
+    }
+    for (auto it = other.begin(); it != other.end(); ++it)
+      append(*it);
+
+    return *this;
+  }
+
+  // Iterators into both lists are invalidated.
+  CompactList& operator=(CompactList&& other)
+  {
+    if (this == &other)
+      return *this;
+
+    moveAssign(other, typename NodeTraits::propagate_on_container_move_assignment());
+
+    return *this;
+  }
+
+  allocator_type getAllocator() const
+  {
+    return allocator_type(nodeAllocator());
+  }
+
+  // Exchanges the node pools. Iterators into either list are invalidated:
+  // they keep their list and index, so they would address the other
+  // list's nodes.
+  void swap(CompactList& other)
+  {
+    steal(other);
+    swapAllocators(other, typename NodeTraits::propagate_on_container_swap());
+  }
+
+  bool isEmpty() const
+  {
+    return !length;
+  }
+
+  size_type getSize() const
+  {
+    return length;
+  }
+
+  // All zero unless AISDI_LINEAR_STATISTICS is 1.
+  using Statistics::getStatistics;
+
+  // Every element takes a whole Node. Nodes of the chunks that hold no
+  // element are slack, the sentinel and the chunk table are overhead.
+  MemoryUsage memoryUsage() const
+  {
+    MemoryUsage usage;
+    size_type pooled = chunks.getSize() * CHUNK_NODES;
+
+    usage.payload = length * sizeof(Type);
+    usage.links = length * (sizeof(Node) - sizeof(Type));
+    usage.slack = pooled != 0 ? (pooled - length - 1) * sizeof(Node) : 0;
+    usage.overhead = sizeof(*this) + (pooled != 0 ? sizeof(Node) : 0)
+                     + chunks.memoryUsage().total() - sizeof(chunks);
+    return usage;
+  }
+
+  // Destroys the elements, their nodes stay pooled for reuse.
+  void clear()
+  {
+    erase(begin(), end());
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
+  }
+
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
+  void prepend(const Type& item)
+  {
+    emplaceFront(item);
+  }
+
+  void prepend(Type&& item)
+  {
+    emplaceFront(std::move(item));
+  }
+
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
+  }
+
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
+
+  template <typename... Args>
+  void emplaceBack(Args&&... args)
+  {
+    Index index = createNode(std::forward<Args>(args)...);
+    linkBefore(SENTINEL, index);
+  }
+
+  template <typename... Args>
+  void emplaceFront(Args&&... args)
+  {
+    Index index = createNode(std::forward<Args>(args)...);
+    linkBefore(node(SENTINEL).next, index);
+  }
+
+  template <typename... Args>
+  void emplace(const const_iterator& insertPosition, Args&&... args)
+  {
+    Index index = createNode(std::forward<Args>(args)...);
+    linkBefore(insertPosition.index, index);
+  }
+
+  Type popFirst()
+  {
+    if (isEmpty())
+      throw std::logic_error("Object cannot be popped.");
+
+    Type obj = std::move(*begin());
+    erase(begin());
+    return obj;
+  }
+
+  Type popLast()
+  {
+    if (isEmpty())
+      throw std::logic_error("Object cannot be popped.");
+
+    Type obj = std::move(*(--end()));
+    erase(--end());
+    return obj;
+  }
+
+  void erase(const const_iterator& position)
+  {
+    if (position == end())
+      throw std::out_of_range("Object cannot be erased.");
+
+    Node& erased = node(position.index);
+
+    node(erased.prev).next = erased.next;
+    node(erased.next).prev = erased.prev;
+    NodeTraits::destroy(nodeAllocator(), erased.valuePtr());
+    recycleNode(position.index);
+    --length;
+  }
+
+  // Unlinks the range at once, then destroys the payloads and hands the
+  // whole chain to the free list.
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+  {
+    if (firstIncluded == lastExcluded)
+      return;
+
+    if (firstIncluded == end())
+      throw std::out_of_range("Object cannot be erased.");
+
+    Index first = firstIncluded.index;
+    Index last = lastExcluded.index;
+    Index index = first;
+    size_type count = 0;
+
+    node(node(first).prev).next = last;
+    node(last).prev = node(first).prev;
+
+    for (;; index = node(index).next)
+    {
+      NodeTraits::destroy(nodeAllocator(), node(index).valuePtr());
+      ++count;
+
+      if (node(index).next == last)
+        break;
+    }
+
+    length -= count;
+    countNodeFrees(count);
+    node(index).next = freeNodes;
+    freeNodes = first;
+  }
+
+  iterator begin()
+  {
+    return iterator(this, chunks.isEmpty() ? SENTINEL : node(SENTINEL).next);
+  }
+
+  iterator end()
+  {
+    return iterator(this, SENTINEL);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(this, chunks.isEmpty() ? SENTINEL : node(SENTINEL).next);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(this, SENTINEL);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type, typename Allocator, typename Index>
+const std::size_t CompactList<Type, Allocator, Index>::CHUNK_BITS;
+template <typename Type, typename Allocator, typename Index>
+const std::size_t CompactList<Type, Allocator, Index>::CHUNK_NODES;
+template <typename Type, typename Allocator, typename Index>
+const Index CompactList<Type, Allocator, Index>::SENTINEL;
+
+template <typename Type, typename Allocator, typename Index>
+class CompactList<Type, Allocator, Index>::ConstIterator
+{
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename CompactList::value_type;
+  using difference_type = typename CompactList::difference_type;
+  using pointer = typename CompactList::const_pointer;
+  using reference = typename CompactList::const_reference;
+
+private:
+  const CompactList *list;
+  Index index;
+  friend class CompactList;
+
+public:
+
+  explicit ConstIterator(const CompactList *owner = nullptr, Index position = SENTINEL)
+    : list(owner), index(position)
+  {}
+
+  reference operator*() const
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (index == SENTINEL)
+      throw std::out_of_range("Out of range.");
+#endif
+    return *list->node(index).valuePtr();
+  }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+
+  ConstIterator& operator++()
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (index == SENTINEL)
+      throw std::out_of_range("Out of range.");
+#endif
+    index = list->node(index).next;
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    auto result = *this;
+    operator++();
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (list->isEmpty() || list->node(index).prev == SENTINEL)
+      throw std::out_of_range("Out of range.");
+#endif
+    index = list->node(index).prev;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    auto result = *this;
+    operator--();
+    return result;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    auto result = *this;
+    for (difference_type i = 0; i < d; ++i)
+      ++result;
+    return result;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    auto result = *this;
+    for (difference_type i = 0; i < d; ++i)
+      --result;
+    return result;
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return index == other.index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return index != other.index;
+  }
+};
+
+template <typename Type, typename Allocator, typename Index>
+class CompactList<Type, Allocator, Index>::Iterator : public CompactList<Type, Allocator, Index>::ConstIterator
+{
+public:
+  using pointer = typename CompactList::pointer;
+  using reference = typename CompactList::reference;
+
+  explicit Iterator(const CompactList *owner = nullptr, Index position = SENTINEL)
+    : ConstIterator(owner, position)
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  reference operator*() const
+  {
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+};
+
+}
+
+#endif // AISDI_LINEAR_COMPACTLIST_H
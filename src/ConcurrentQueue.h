@@ -0,0 +1,400 @@
+#ifndef AISDI_LINEAR_CONCURRENTQUEUE_H
+#define AISDI_LINEAR_CONCURRENTQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Vector.h"
+
+namespace aisdi
+{
+
+// Unbounded multi-producer multi-consumer FIFO, the Michael-Scott queue.
+// Nodes follow the LinkedList layout, links plus the payload constructed
+// in place through the allocator. A node is freed only when no thread
+// holds a hazard pointer to it. Each operation borrows a hazard record
+// from a per-queue list that only grows, up to one record per thread that
+// ever used the queue concurrently.
+template <typename Type, typename Allocator = std::allocator<Type>>
+class ConcurrentQueue
+{
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using allocator_type = Allocator;
+
+  struct Node
+  {
+    std::atomic<Node*> next;
+    Node *retiredNext;
+    typename std::aligned_storage<sizeof(Type), alignof(Type)>::type storage;
+    Node(): next(nullptr), retiredNext(nullptr){}
+    Type* valuePtr() {return reinterpret_cast<Type*>(&storage);}
+  };
+
+private:
+  static const size_type HAZARDS_PER_RECORD = 2;
+  static const size_type CACHE_LINE = 64;
+
+  struct HazardRecord
+  {
+    std::atomic<Node*> hazards[HAZARDS_PER_RECORD];
+    std::atomic<bool> active;
+    HazardRecord *next;
+    Node *retired;
+    size_type retiredCount;
+
+    HazardRecord(): active(true), next(nullptr), retired(nullptr), retiredCount(0)
+    {
+      for (auto& hazard : hazards)
+        hazard.store(nullptr);
+    }
+  };
+
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+  using RecordAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<HazardRecord>;
+  using RecordTraits = std::allocator_traits<RecordAllocator>;
+
+  static_assert(std::is_same<typename NodeTraits::pointer, Node*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  // head and tail on separate cache lines, consumers and producers do not
+  // invalidate each other's line.
+  alignas(CACHE_LINE) std::atomic<Node*> head;
+  alignas(CACHE_LINE) std::atomic<Node*> tail;
+  alignas(CACHE_LINE) std::atomic<HazardRecord*> records;
+  std::atomic<size_type> recordCount;
+  NodeAllocator nodeAllocator;
+  RecordAllocator recordAllocator;
+
+  Node* allocateNode()
+  {
+    Node *node = NodeTraits::allocate(nodeAllocator, 1);
+    ::new (static_cast<void*>(node)) Node;
+    return node;
+  }
+
+  void deallocateNode(Node *node)
+  {
+    node->~Node();
+    NodeTraits::deallocate(nodeAllocator, node, 1);
+  }
+
+  template <typename... Args>
+  Node* createNode(Args&&... args)
+  {
+    Node *node = allocateNode();
+
+    try
+    {
+      NodeTraits::construct(nodeAllocator, node->valuePtr(), std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      deallocateNode(node);
+      throw;
+    }
+
+    return node;
+  }
+
+  HazardRecord* acquireRecord()
+  {
+    for (HazardRecord *record = records.load(); record != nullptr; record = record->next)
+      if (!record->active.load(std::memory_order_relaxed) && !record->active.exchange(true))
+        return record;
+
+    HazardRecord *record = RecordTraits::allocate(recordAllocator, 1);
+    ::new (static_cast<void*>(record)) HazardRecord;
+
+    record->next = records.load();
+    while (!records.compare_exchange_weak(record->next, record))
+      ;
+    ++recordCount;
+
+    return record;
+  }
+
+  static void releaseRecord(HazardRecord *record)
+  {
+    for (auto& hazard : record->hazards)
+      hazard.store(nullptr, std::memory_order_release);
+    record->active.store(false, std::memory_order_release);
+  }
+
+  // Publishes source's current value as a hazard and returns it once it is
+  // known to have still been current after publishing.
+  static Node* protect(HazardRecord *record, size_type slot, const std::atomic<Node*>& source)
+  {
+    Node *node = source.load();
+
+    for (;;)
+    {
+      record->hazards[slot].store(node);
+      Node *again = source.load();
+      if (again == node)
+        return node;
+      node = again;
+    }
+  }
+
+  void retire(HazardRecord *record, Node *node)
+  {
+    node->retiredNext = record->retired;
+    record->retired = node;
+
+    if (++record->retiredCount >= 2 * HAZARDS_PER_RECORD * recordCount.load() + 16)
+      scan(record);
+  }
+
+  // Frees the record's retired nodes that no thread has a hazard on.
+  void scan(HazardRecord *record)
+  {
+    Vector<Node*> hazards;
+
+    for (HazardRecord *i = records.load(); i != nullptr; i = i->next)
+      for (auto& hazard : i->hazards)
+        if (Node *node = hazard.load())
+          hazards.append(node);
+
+    std::sort(hazards.data(), hazards.data() + hazards.getSize());
+
+    Node *kept = nullptr;
+    size_type keptCount = 0;
+
+    for (Node *node = record->retired; node != nullptr;)
+    {
+      Node *next = node->retiredNext;
+
+      if (std::binary_search(hazards.data(), hazards.data() + hazards.getSize(), node))
+      {
+        node->retiredNext = kept;
+        kept = node;
+        ++keptCount;
+      }
+      else
+        deallocateNode(node);
+
+      node = next;
+    }
+
+    record->retired = kept;
+    record->retiredCount = keptCount;
+  }
+
+  // Links the chain [first, last] after the current last node.
+  void linkChain(HazardRecord *record, Node *first, Node *last)
+  {
+    for (;;)
+    {
+      Node *observed = protect(record, 0, tail);
+      Node *next = observed->next.load();
+
+      if (observed != tail.load())
+        continue;
+
+      if (next != nullptr)
+      {
+        // another push is halfway done, help it
+        tail.compare_exchange_weak(observed, next);
+        continue;
+      }
+
+      if (observed->next.compare_exchange_weak(next, first))
+      {
+        tail.compare_exchange_strong(observed, last);
+        break;
+      }
+    }
+
+    record->hazards[0].store(nullptr, std::memory_order_release);
+  }
+
+  bool popWith(HazardRecord *record, Type& value)
+  {
+    for (;;)
+    {
+      Node *first = protect(record, 0, head);
+      Node *last = tail.load();
+      Node *next = first->next.load();
+      record->hazards[1].store(next);
+
+      if (first != head.load())
+        continue;
+
+      if (next == nullptr)
+        return false;
+
+      if (first == last)
+      {
+        tail.compare_exchange_weak(last, next);
+        continue;
+      }
+
+      if (head.compare_exchange_weak(first, next))
+      {
+        // next is the new dummy, its payload belongs to this thread only
+        value = std::move(*next->valuePtr());
+        NodeTraits::destroy(nodeAllocator, next->valuePtr());
+
+        record->hazards[0].store(nullptr, std::memory_order_release);
+        record->hazards[1].store(nullptr, std::memory_order_release);
+        retire(record, first);
+        return true;
+      }
+    }
+  }
+
+public:
+
+  explicit ConcurrentQueue(const allocator_type& alloc = allocator_type())
+    : head(nullptr), tail(nullptr), records(nullptr), recordCount(0),
+      nodeAllocator(alloc), recordAllocator(alloc)
+  {
+    Node *dummy = allocateNode();
+
+    head.store(dummy);
+    tail.store(dummy);
+  }
+
+  ConcurrentQueue(const ConcurrentQueue&) = delete;
+  ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+  // No other thread may use the queue any more.
+  ~ConcurrentQueue()
+  {
+    Node *dummy = head.load();
+
+    for (Node *node = dummy->next.load(); node != nullptr;)
+    {
+      Node *next = node->next.load();
+      NodeTraits::destroy(nodeAllocator, node->valuePtr());
+      deallocateNode(node);
+      node = next;
+    }
+    deallocateNode(dummy);
+
+    for (HazardRecord *record = records.load(); record != nullptr;)
+    {
+      HazardRecord *next = record->next;
+
+      for (Node *node = record->retired; node != nullptr;)
+      {
+        Node *retiredNext = node->retiredNext;
+        deallocateNode(node);
+        node = retiredNext;
+      }
+
+      record->~HazardRecord();
+      RecordTraits::deallocate(recordAllocator, record, 1);
+      record = next;
+    }
+  }
+
+  allocator_type getAllocator() const
+  {
+    return allocator_type(nodeAllocator);
+  }
+
+  void push(const Type& item)
+  {
+    emplace(item);
+  }
+
+  void push(Type&& item)
+  {
+    emplace(std::move(item));
+  }
+
+  template <typename... Args>
+  void emplace(Args&&... args)
+  {
+    Node *node = createNode(std::forward<Args>(args)...);
+    HazardRecord *record = acquireRecord();
+
+    linkChain(record, node, node);
+    releaseRecord(record);
+  }
+
+  // Builds the chain privately and links all of it with a single CAS.
+  template <typename InputIt>
+  void pushMany(InputIt first, InputIt last)
+  {
+    if (first == last)
+      return;
+
+    Node *chainFirst = createNode(*first);
+    Node *chainLast = chainFirst;
+
+    try
+    {
+      for (++first; first != last; ++first)
+      {
+        Node *node = createNode(*first);
+        chainLast->next.store(node, std::memory_order_relaxed);
+        chainLast = node;
+      }
+    }
+    catch (...)
+    {
+      for (Node *node = chainFirst; node != nullptr;)
+      {
+        Node *next = node->next.load(std::memory_order_relaxed);
+        NodeTraits::destroy(nodeAllocator, node->valuePtr());
+        deallocateNode(node);
+        node = next;
+      }
+      throw;
+    }
+
+    HazardRecord *record = acquireRecord();
+
+    linkChain(record, chainFirst, chainLast);
+    releaseRecord(record);
+  }
+
+  // Moves the oldest element into value, false when the queue was empty.
+  bool tryPop(Type& value)
+  {
+    HazardRecord *record = acquireRecord();
+    bool popped = popWith(record, value);
+
+    releaseRecord(record);
+    return popped;
+  }
+
+  // Pops up to maxCount elements into out, sharing one hazard record.
+  template <typename OutputIt>
+  size_type popMany(OutputIt out, size_type maxCount)
+  {
+    HazardRecord *record = acquireRecord();
+    size_type count = 0;
+
+    try
+    {
+      for (Type value; count < maxCount && popWith(record, value); ++count)
+        *out++ = std::move(value);
+    }
+    catch (...)
+    {
+      releaseRecord(record);
+      throw;
+    }
+
+    releaseRecord(record);
+    return count;
+  }
+};
+
+template <typename Type, typename Allocator>
+const std::size_t ConcurrentQueue<Type, Allocator>::HAZARDS_PER_RECORD;
+
+}
+
+#endif // AISDI_LINEAR_CONCURRENTQUEUE_H
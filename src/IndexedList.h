@@ -0,0 +1,971 @@
+#ifndef AISDI_LINEAR_INDEXEDLIST_H
+#define AISDI_LINEAR_INDEXEDLIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "AllocatorStorage.h"
+#include "Statistics.h"
+
+// With AISDI_CHECKED_ITERATORS set (the default unless NDEBUG) iterators
+// throw std::out_of_range when moved or dereferenced out of the list.
+#ifndef AISDI_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define AISDI_CHECKED_ITERATORS 0
+#else
+#define AISDI_CHECKED_ITERATORS 1
+#endif
+#endif
+
+namespace aisdi
+{
+
+namespace detail
+{
+
+// List and tree links. The sentinel is a plain IndexedListNodeBase with
+// size 0 whose parent is the root of the tree; every element node has
+// size >= 1.
+struct IndexedListNodeBase
+{
+  IndexedListNodeBase *prev;
+  IndexedListNodeBase *next;
+  IndexedListNodeBase *parent;
+  IndexedListNodeBase *left;
+  IndexedListNodeBase *right;
+  std::size_t size;
+  std::uint32_t priority;
+  IndexedListNodeBase(): prev(this), next(this), parent(nullptr), left(nullptr), right(nullptr), size(0), priority(0){}
+};
+
+template <typename Type>
+struct IndexedListNode : IndexedListNodeBase
+{
+  typename std::aligned_storage<sizeof(Type), alignof(Type)>::type storage;
+  Type* valuePtr() {return reinterpret_cast<Type*>(&storage);}
+};
+
+}
+
+// A list that can also be addressed by position. The nodes form an
+// implicit treap: a binary tree ordered by position, heap ordered by random
+// priorities and augmented with subtree sizes. Every node is threaded into
+// a doubly linked list as well, so stepping an iterator is O(1) while
+// iteratorAt, indexOf, it + k and inserting or erasing at an iterator are
+// O(log n) expected.
+template <typename Type, typename Allocator = std::allocator<Type>>
+class IndexedList : private AllocatorStorage<ReboundAllocator<Allocator, detail::IndexedListNode<Type>>>, private Statistics
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using allocator_type = Allocator;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  using NodeBase = detail::IndexedListNodeBase;
+  using Node = detail::IndexedListNode<Type>;
+
+private:
+  using NodeAllocator = ReboundAllocator<Allocator, Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  static_assert(std::is_same<typename NodeTraits::pointer, Node*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  NodeAllocator& nodeAllocator()
+  {
+    return this->storedAllocator();
+  }
+
+  const NodeAllocator& nodeAllocator() const
+  {
+    return this->storedAllocator();
+  }
+
+  NodeBase sentinel;
+  std::uint32_t seed;
+
+  static size_type sizeOf(const NodeBase *node)
+  {
+    return node != nullptr ? node->size : 0;
+  }
+
+  static bool isSentinel(const NodeBase *node)
+  {
+    return node->size == 0;
+  }
+
+  static void update(NodeBase *node)
+  {
+    node->size = sizeOf(node->left) + sizeOf(node->right) + 1;
+  }
+
+  // xorshift32, priorities only need to look random.
+  // Differs between lists, also between ones built at the same address
+  // one after another, so that lists filled the same way do not share one
+  // tree shape. Mixes the address with a global counter.
+  std::uint32_t initialSeed() const
+  {
+    static std::atomic<std::uint64_t> created(0);
+    std::uint64_t mixed = reinterpret_cast<std::uintptr_t>(this)
+      ^ created.fetch_add(1, std::memory_order_relaxed) * 0x9e3779b97f4a7c15ull;
+
+    mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+    mixed ^= mixed >> 31;
+
+    // xorshift would stay at zero forever
+    std::uint32_t folded = static_cast<std::uint32_t>(mixed ^ (mixed >> 32));
+    return folded != 0 ? folded : 2463534242u;
+  }
+
+  std::uint32_t nextPriority()
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+  }
+
+  NodeBase* root() const
+  {
+    return sentinel.parent;
+  }
+
+  void setRoot(NodeBase *node)
+  {
+    sentinel.parent = node;
+    if (node != nullptr)
+      node->parent = &sentinel;
+  }
+
+  // Lifts node above its parent, keeping the in-order sequence.
+  static void rotateUp(NodeBase *node)
+  {
+    NodeBase *parent = node->parent;
+    NodeBase *grand = parent->parent;
+
+    if (node == parent->left)
+    {
+      parent->left = node->right;
+      if (parent->left != nullptr)
+        parent->left->parent = parent;
+      node->right = parent;
+    }
+    else
+    {
+      parent->right = node->left;
+      if (parent->right != nullptr)
+        parent->right->parent = parent;
+      node->left = parent;
+    }
+
+    parent->parent = node;
+    node->parent = grand;
+
+    if (isSentinel(grand))
+      grand->parent = node;
+    else if (grand->left == parent)
+      grand->left = node;
+    else
+      grand->right = node;
+
+    node->size = parent->size;
+    update(parent);
+  }
+
+  // Moves d positions away from node: climbs until the target lies in the
+  // current subtree, then descends to it. Costs O(log n), less for short hops.
+  static NodeBase* advance(NodeBase *node, difference_type d)
+  {
+    if (d == 0)
+      return node;
+
+    NodeBase *current;
+    difference_type target;
+
+    if (isSentinel(node))
+    {
+      current = node->parent;
+      target = static_cast<difference_type>(sizeOf(current)) + d;
+    }
+    else
+    {
+      current = node;
+      target = static_cast<difference_type>(sizeOf(node->left)) + d;
+    }
+
+    while (current != nullptr && (target < 0 || target >= static_cast<difference_type>(current->size)))
+    {
+      NodeBase *parent = current->parent;
+
+      if (isSentinel(parent))
+      {
+        if (target == static_cast<difference_type>(current->size))
+          return parent;
+        current = nullptr;
+        break;
+      }
+
+      if (current == parent->right)
+        target += sizeOf(parent->left) + 1;
+      current = parent;
+    }
+
+    if (current == nullptr)
+    {
+#if AISDI_CHECKED_ITERATORS
+      throw std::out_of_range("Out of range.");
+#else
+      return isSentinel(node) ? node : headerOf(node);
+#endif
+    }
+
+    return descend(current, static_cast<size_type>(target));
+  }
+
+  static NodeBase* descend(NodeBase *node, size_type index)
+  {
+    for (;;)
+    {
+      size_type before = sizeOf(node->left);
+
+      if (index < before)
+        node = node->left;
+      else if (index == before)
+        return node;
+      else
+      {
+        index -= before + 1;
+        node = node->right;
+      }
+    }
+  }
+
+  static NodeBase* headerOf(NodeBase *node)
+  {
+    while (!isSentinel(node))
+      node = node->parent;
+    return node;
+  }
+
+  static size_type rankOf(const NodeBase *node)
+  {
+    if (isSentinel(node))
+      return sizeOf(node->parent);
+
+    size_type rank = sizeOf(node->left);
+
+    for (; !isSentinel(node->parent); node = node->parent)
+      if (node == node->parent->right)
+        rank += sizeOf(node->parent->left) + 1;
+
+    return rank;
+  }
+
+  // Splits the tree under node into its first count elements and the rest.
+  static void split(NodeBase *node, size_type count, NodeBase *&first, NodeBase *&rest)
+  {
+    if (node == nullptr)
+    {
+      first = rest = nullptr;
+      return;
+    }
+
+    if (sizeOf(node->left) < count)
+    {
+      split(node->right, count - sizeOf(node->left) - 1, node->right, rest);
+      if (node->right != nullptr)
+        node->right->parent = node;
+      first = node;
+    }
+    else
+    {
+      split(node->left, count, first, node->left);
+      if (node->left != nullptr)
+        node->left->parent = node;
+      rest = node;
+    }
+
+    update(node);
+  }
+
+  // Joins two trees, every element of first preceding those of rest.
+  static NodeBase* merge(NodeBase *first, NodeBase *rest)
+  {
+    if (first == nullptr)
+      return rest;
+    if (rest == nullptr)
+      return first;
+
+    if (first->priority > rest->priority)
+    {
+      first->right = merge(first->right, rest);
+      first->right->parent = first;
+      update(first);
+      return first;
+    }
+
+    rest->left = merge(first, rest->left);
+    rest->left->parent = rest;
+    update(rest);
+    return rest;
+  }
+
+  template <typename... Args>
+  Node* createNode(Args&&... args)
+  {
+    Node *node = NodeTraits::allocate(nodeAllocator(), 1);
+
+    try
+    {
+      NodeTraits::construct(nodeAllocator(), node->valuePtr(), std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      NodeTraits::deallocate(nodeAllocator(), node, 1);
+      throw;
+    }
+
+    countAllocation(sizeof(Node));
+    countNodeAllocation();
+    countCapacity(getSize() + 1);
+
+    node->left = node->right = nullptr;
+    node->size = 1;
+    node->priority = nextPriority();
+    return node;
+  }
+
+  void destroyNode(NodeBase *base)
+  {
+    Node *node = static_cast<Node*>(base);
+
+    NodeTraits::destroy(nodeAllocator(), node->valuePtr());
+    NodeTraits::deallocate(nodeAllocator(), node, 1);
+    countDeallocation();
+    countNodeFrees(1);
+  }
+
+  static void linkBetween(NodeBase *prev, NodeBase *first, NodeBase *last, NodeBase *next)
+  {
+    first->prev = prev;
+    last->next = next;
+    prev->next = first;
+    next->prev = last;
+  }
+
+  // Hangs node in front of position as a leaf, then restores the heap order.
+  void linkBefore(NodeBase *position, NodeBase *node)
+  {
+    NodeBase *parent;
+
+    if (root() == nullptr)
+    {
+      setRoot(node);
+      parent = &sentinel;
+    }
+    else if (position->left == nullptr && !isSentinel(position))
+    {
+      parent = position;
+      parent->left = node;
+    }
+    else
+    {
+      parent = position->prev;
+      parent->right = node;
+    }
+
+    if (!isSentinel(parent))
+    {
+      node->parent = parent;
+      for (NodeBase *i = parent; !isSentinel(i); i = i->parent)
+        ++i->size;
+    }
+
+    linkBetween(position->prev, node, node, position);
+
+    while (!isSentinel(node->parent) && node->parent->priority < node->priority)
+      rotateUp(node);
+  }
+
+  // Rotates node down to a leaf and cuts it off the tree and the list.
+  void unlink(NodeBase *node)
+  {
+    while (node->left != nullptr || node->right != nullptr)
+    {
+      NodeBase *child;
+
+      if (node->left == nullptr)
+        child = node->right;
+      else if (node->right == nullptr)
+        child = node->left;
+      else
+        child = node->left->priority > node->right->priority ? node->left : node->right;
+
+      rotateUp(child);
+    }
+
+    NodeBase *parent = node->parent;
+
+    if (isSentinel(parent))
+      parent->parent = nullptr;
+    else
+    {
+      if (parent->left == node)
+        parent->left = nullptr;
+      else
+        parent->right = nullptr;
+
+      for (NodeBase *i = parent; !isSentinel(i); i = i->parent)
+        --i->size;
+    }
+
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+  }
+
+  // Destroys the threaded chain [first, last).
+  void destroyChain(NodeBase *first, NodeBase *last)
+  {
+    while (first != last)
+    {
+      NodeBase *next = first->next;
+      destroyNode(first);
+      first = next;
+    }
+  }
+
+  // Makes the sentinel own the given tree and chain, or nothing.
+  void adopt(NodeBase *tree, NodeBase *first, NodeBase *last)
+  {
+    setRoot(tree);
+
+    if (tree == nullptr)
+      sentinel.prev = sentinel.next = &sentinel;
+    else
+      linkBetween(&sentinel, first, last, &sentinel);
+  }
+
+  void steal(IndexedList& other)
+  {
+    if (other.isEmpty())
+      return;
+
+    adopt(other.root(), other.sentinel.next, other.sentinel.prev);
+    other.adopt(nullptr, nullptr, nullptr);
+  }
+
+  void moveAssign(IndexedList& other, std::true_type)
+  {
+    clear();
+    nodeAllocator() = std::move(other.nodeAllocator());
+    steal(other);
+  }
+
+  void moveAssign(IndexedList& other, std::false_type)
+  {
+    clear();
+
+    if (nodeAllocator() == other.nodeAllocator())
+    {
+      steal(other);
+      return;
+    }
+
+    for (NodeBase *i = other.sentinel.next; i != &other.sentinel; i = i->next)
+      emplaceBack(std::move(*static_cast<Node*>(i)->valuePtr()));
+    other.clear();
+  }
+
+  void swapAllocators(IndexedList& other, std::true_type)
+  {
+    using std::swap;
+    swap(nodeAllocator(), other.nodeAllocator());
+  }
+
+  void swapAllocators(IndexedList&, std::false_type)
+  {}
+
+public:
+
+  IndexedList(): IndexedList(allocator_type())
+  {}
+
+  explicit IndexedList(const allocator_type& alloc)
+    : AllocatorStorage<NodeAllocator>(alloc), sentinel(), seed(initialSeed())
+  {}
+
+  IndexedList(std::initializer_list<Type> l, const allocator_type& alloc = allocator_type()):IndexedList(alloc)
+  {
+    for (auto it = l.begin(); it != l.end(); ++it)
+      append(*it);
+  }
+
+  IndexedList(const IndexedList& other)
+    :IndexedList(allocator_type(NodeTraits::select_on_container_copy_construction(other.nodeAllocator())))
+  {
+    for (auto it = other.begin(); it != other.end(); ++it)
+      append(*it);
+  }
+
+  IndexedList(IndexedList&& other):IndexedList(allocator_type(other.nodeAllocator()))
+  {
+    steal(other);
+  }
+
+  ~IndexedList()
+  {
+    clear();
+  }
+
+  IndexedList& operator=(const IndexedList& other)
+  {
+    if (this == &other)
+      return *this;
+
+    clear();
+    if (NodeTraits::propagate_on_container_copy_assignment::value)
+      nodeAllocator() = other.nodeAllocator();
+    for (auto it = other.begin(); it != other.end(); ++it)
+      append(*it);
+
+    return *this;
+  }
+
+  IndexedList& operator=(IndexedList&& other)
+  {
+    if (this == &other)
+      return *this;
+
+    moveAssign(other, typename NodeTraits::propagate_on_container_move_assignment());
+
+    return *this;
+  }
+
+  allocator_type getAllocator() const
+  {
+    return allocator_type(nodeAllocator());
+  }
+
+  void swap(IndexedList& other)
+  {
+    NodeBase *tree = root();
+    NodeBase *first = sentinel.next;
+    NodeBase *last = sentinel.prev;
+
+    adopt(other.root(), other.sentinel.next, other.sentinel.prev);
+    other.adopt(tree, first, last);
+
+    swapAllocators(other, typename NodeTraits::propagate_on_container_swap());
+  }
+
+  // Moves all of other's elements in front of position by splitting this
+  // tree and merging other's into the gap, O(log n) expected. With
+  // allocators that compare unequal the elements are moved one by one.
+  void splice(const const_iterator& position, IndexedList& other)
+  {
+    if (this == &other || other.isEmpty())
+      return;
+
+    if (nodeAllocator() != other.nodeAllocator())
+    {
+      for (NodeBase *i = other.sentinel.next; i != &other.sentinel; i = i->next)
+        emplace(position, std::move(*static_cast<Node*>(i)->valuePtr()));
+      other.clear();
+      return;
+    }
+
+    NodeBase *first;
+    NodeBase *rest;
+    NodeBase *otherFirst = other.sentinel.next;
+    NodeBase *otherLast = other.sentinel.prev;
+
+    split(root(), rankOf(position.pointee), first, rest);
+    setRoot(merge(merge(first, other.root()), rest));
+
+    linkBetween(position.pointee->prev, otherFirst, otherLast, position.pointee);
+    other.adopt(nullptr, nullptr, nullptr);
+  }
+
+  bool isEmpty() const
+  {
+    return root() == nullptr;
+  }
+
+  size_type getSize() const
+  {
+    return sizeOf(root());
+  }
+
+  // All zero unless AISDI_LINEAR_STATISTICS is 1.
+  using Statistics::getStatistics;
+
+  // One allocation per element, holding its list and tree links.
+  MemoryUsage memoryUsage() const
+  {
+    MemoryUsage usage;
+
+    usage.payload = getSize() * sizeof(Type);
+    usage.links = getSize() * (sizeof(Node) - sizeof(Type));
+    usage.overhead = sizeof(*this);
+    return usage;
+  }
+
+  void clear()
+  {
+    destroyChain(sentinel.next, &sentinel);
+    adopt(nullptr, nullptr, nullptr);
+  }
+
+  // Iterator to the element at index, end() for index == getSize().
+  iterator iteratorAt(size_type index)
+  {
+    return iterator(static_cast<const IndexedList&>(*this).iteratorAt(index).pointee);
+  }
+
+  const_iterator iteratorAt(size_type index) const
+  {
+    NodeBase *end = const_cast<NodeBase*>(&sentinel);
+
+    if (index == getSize())
+      return const_iterator(end);
+
+    if (index > getSize())
+      throw std::out_of_range("Index out of range.");
+
+    return const_iterator(descend(end->parent, index));
+  }
+
+  size_type indexOf(const const_iterator& position) const
+  {
+    return rankOf(position.pointee);
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
+  }
+
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
+  void prepend(const Type& item)
+  {
+    emplaceFront(item);
+  }
+
+  void prepend(Type&& item)
+  {
+    emplaceFront(std::move(item));
+  }
+
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
+  }
+
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
+
+  template <typename... Args>
+  void emplaceBack(Args&&... args)
+  {
+    linkBefore(&sentinel, createNode(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  void emplaceFront(Args&&... args)
+  {
+    linkBefore(sentinel.next, createNode(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  void emplace(const const_iterator& insertPosition, Args&&... args)
+  {
+    linkBefore(insertPosition.pointee, createNode(std::forward<Args>(args)...));
+  }
+
+  Type popFirst()
+  {
+    if (isEmpty())
+      throw std::logic_error("Object cannot be popped.");
+
+    Type obj = std::move(*begin());
+    erase(begin());
+    return obj;
+  }
+
+  Type popLast()
+  {
+    if (isEmpty())
+      throw std::logic_error("Object cannot be popped.");
+
+    Type obj = std::move(*(--end()));
+    erase(--end());
+    return obj;
+  }
+
+  void erase(const const_iterator& position)
+  {
+    if (isSentinel(position.pointee))
+      throw std::out_of_range("Object cannot be erased.");
+
+    unlink(position.pointee);
+    destroyNode(position.pointee);
+  }
+
+  // Cuts the range out of the tree with two splits, then frees its nodes.
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+  {
+    if (firstIncluded == lastExcluded)
+      return;
+
+    NodeBase *first = firstIncluded.pointee;
+    NodeBase *last = lastExcluded.pointee;
+    NodeBase *before;
+    NodeBase *middle;
+    NodeBase *after;
+    size_type firstRank = rankOf(first);
+
+    split(root(), rankOf(last), middle, after);
+    split(middle, firstRank, before, middle);
+    setRoot(merge(before, after));
+
+    NodeBase *prev = first->prev;
+    prev->next = last;
+    last->prev = prev;
+
+    destroyChain(first, last);
+  }
+
+  iterator begin()
+  {
+    return iterator(sentinel.next);
+  }
+
+  iterator end()
+  {
+    return iterator(&sentinel);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(sentinel.next);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(const_cast<NodeBase*>(&sentinel));
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type, typename Allocator>
+class IndexedList<Type, Allocator>::ConstIterator
+{
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename IndexedList::value_type;
+  using difference_type = typename IndexedList::difference_type;
+  using pointer = typename IndexedList::const_pointer;
+  using reference = typename IndexedList::const_reference;
+
+private:
+  NodeBase *pointee;
+  friend class IndexedList;
+
+public:
+
+  explicit ConstIterator(NodeBase *pnt = nullptr) : pointee(pnt)
+  {}
+
+  reference operator*() const
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (isSentinel(pointee))
+        throw std::out_of_range("Out of range.");
+#endif
+    return *static_cast<Node*>(pointee)->valuePtr();
+  }
+
+  ConstIterator& operator++()
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (isSentinel(pointee))
+        throw std::out_of_range("Out of range.");
+#endif
+    pointee = pointee->next;
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    auto result = *this;
+    operator++();
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (isSentinel(pointee->prev))
+        throw std::out_of_range("Out of range.");
+#endif
+    pointee = pointee->prev;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    auto result = *this;
+    operator--();
+    return result;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    pointee = advance(pointee, d);
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    pointee = advance(pointee, -d);
+    return *this;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    auto result = *this;
+    result += d;
+    return result;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    auto result = *this;
+    result -= d;
+    return result;
+  }
+
+  // O(log n), both iterators must belong to the same list.
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(rankOf(pointee)) - static_cast<difference_type>(rankOf(other.pointee));
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->pointee == other.pointee;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return this->pointee != other.pointee;
+  }
+};
+
+template <typename Type, typename Allocator>
+class IndexedList<Type, Allocator>::Iterator : public IndexedList<Type, Allocator>::ConstIterator
+{
+public:
+  using pointer = typename IndexedList::pointer;
+  using reference = typename IndexedList::reference;
+
+  explicit Iterator(NodeBase *pnt = nullptr): ConstIterator(pnt)
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  using ConstIterator::operator-;
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+};
+
+}
+
+#endif // AISDI_LINEAR_INDEXEDLIST_H
@@ -2,19 +2,61 @@
 #define AISDI_LINEAR_LINKEDLIST_H
 
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "AllocatorStorage.h"
+#include "Statistics.h"
+
+// With AISDI_CHECKED_ITERATORS set (the default unless NDEBUG) stepping
+// past the sentinels throws std::out_of_range, otherwise it is not checked.
+#ifndef AISDI_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define AISDI_CHECKED_ITERATORS 0
+#else
+#define AISDI_CHECKED_ITERATORS 1
+#endif
+#endif
 
 namespace aisdi
 {
 
+namespace detail
+{
+
+// Links only; the sentinels are plain LinkedListNodeBase objects without a
+// payload.
+struct LinkedListNodeBase
+{
+  LinkedListNodeBase *prev;
+  LinkedListNodeBase *next;
+  LinkedListNodeBase(): prev(nullptr), next(nullptr){}
+};
+
+// Element node, the value lives in the same allocation as its links.
+// The payload is constructed separately through the allocator.
 template <typename Type>
-class LinkedList
+struct LinkedListNode : LinkedListNodeBase
+{
+  typename std::aligned_storage<sizeof(Type), alignof(Type)>::type storage;
+  Type* valuePtr() {return reinterpret_cast<Type*>(&storage);}
+};
+
+}
+
+template <typename Type, typename Allocator = std::allocator<Type>>
+class LinkedList : private AllocatorStorage<ReboundAllocator<Allocator, detail::LinkedListNode<Type>>>, private Statistics
 {
 public:
   using difference_type = std::ptrdiff_t;
   using size_type = std::size_t;
   using value_type = Type;
+  using allocator_type = Allocator;
   using pointer = Type*;
   using reference = Type&;
   using const_pointer = const Type*;
@@ -25,32 +67,369 @@ public:
   using iterator = Iterator;
   using const_iterator = ConstIterator;
 
-  struct Node
+  using NodeBase = detail::LinkedListNodeBase;
+  using Node = detail::LinkedListNode<Type>;
+
+private:
+  using NodeAllocator = ReboundAllocator<Allocator, Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  static_assert(std::is_same<typename NodeTraits::pointer, Node*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  NodeAllocator& nodeAllocator()
+  {
+    return this->storedAllocator();
+  }
+
+  const NodeAllocator& nodeAllocator() const
+  {
+    return this->storedAllocator();
+  }
+
+  // Nodes are carved out of slabs, arrays of Node obtained from the
+  // allocator in one piece. The first node of every slab holds its header,
+  // the rest are handed out in order and recycled through freeNodes.
+  struct Slab
   {
-    Type *obj;
-    Node *prev;
     Node *next;
-    Node(): obj(nullptr), prev(nullptr), next(nullptr){}
-    Node(Type object): Node() {obj = new Type (object);}
-    ~Node() {delete obj;}
+    size_type capacity;
+    size_type freeCount;
   };
 
-private:
-  Node *head;
-  Node *tail;
+  static_assert(sizeof(Slab) <= sizeof(Node), "Slab header must fit in a node");
+
+  static const size_type MIN_SLAB_NODES = 16;
+
+  NodeBase head;
+  NodeBase tail;
   size_type length;
 
+  Node *slabs;
+  Node *lastSlab;
+  NodeBase *freeNodes;
+  NodeBase *lastFreeNode;
+  Node *bumpNext;
+  Node *bumpEnd;
+  size_type pooledNodes;
+
+  static Slab* header(Node *slab)
+  {
+    return reinterpret_cast<Slab*>(slab);
+  }
+
+  Node* slabOf(NodeBase *node) const
+  {
+    const Node *target = static_cast<const Node*>(node);
+
+    for (Node *slab = slabs; ; slab = header(slab)->next)
+      if (std::less_equal<const Node*>()(slab + 1, target)
+          && std::less<const Node*>()(target, slab + 1 + header(slab)->capacity))
+        return slab;
+  }
+
+  // Puts the chain first..last, linked through next, on the free list.
+  void pushFree(NodeBase *first, NodeBase *last)
+  {
+    if (freeNodes == nullptr)
+      lastFreeNode = last;
+    last->next = freeNodes;
+    freeNodes = first;
+  }
+
+  // Returns the untouched remainder of the newest slab to the free list.
+  void retireBump()
+  {
+    for (; bumpNext != bumpEnd; ++bumpNext)
+      pushFree(bumpNext, bumpNext);
+  }
+
+  void addSlab(size_type count)
+  {
+    Node *slab = NodeTraits::allocate(nodeAllocator(), count + 1);
+
+    ::new (static_cast<void*>(slab)) Slab{slabs, count, 0};
+    countAllocation((count + 1) * sizeof(Node));
+
+    retireBump();
+    if (slabs == nullptr)
+      lastSlab = slab;
+    slabs = slab;
+    bumpNext = slab + 1;
+    bumpEnd = bumpNext + count;
+    pooledNodes += count;
+    countCapacity(pooledNodes);
+  }
+
+  void releaseSlab(Node *slab)
+  {
+    size_type count = header(slab)->capacity;
+
+    pooledNodes -= count;
+    NodeTraits::deallocate(nodeAllocator(), slab, count + 1);
+    countDeallocation();
+  }
+
+  // Frees every slab, the list must not hold any element.
+  void releasePool()
+  {
+    while (slabs != nullptr)
+    {
+      Node *next = header(slabs)->next;
+      releaseSlab(slabs);
+      slabs = next;
+    }
+
+    lastSlab = nullptr;
+    freeNodes = lastFreeNode = nullptr;
+    bumpNext = bumpEnd = nullptr;
+  }
+
+  Node* acquireNode()
+  {
+    countNodeAllocation();
+
+    if (freeNodes != nullptr)
+    {
+      Node *node = static_cast<Node*>(freeNodes);
+      freeNodes = freeNodes->next;
+      if (freeNodes == nullptr)
+        lastFreeNode = nullptr;
+      return node;
+    }
+
+    if (bumpNext == bumpEnd)
+    {
+      // grows the pool geometrically
+      size_type count = pooledNodes;
+      if (count < MIN_SLAB_NODES)
+        count = MIN_SLAB_NODES;
+      addSlab(count);
+    }
+
+    return bumpNext++;
+  }
+
+  void recycleNode(NodeBase *node)
+  {
+    countNodeFrees(1);
+    pushFree(node, node);
+  }
+
+  template <typename... Args>
+  Node* createNode(Args&&... args)
+  {
+    Node *node = acquireNode();
+
+    ::new (static_cast<void*>(node)) Node;
+
+    try
+    {
+      NodeTraits::construct(nodeAllocator(), node->valuePtr(), std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      recycleNode(node);
+      throw;
+    }
+
+    return node;
+  }
+
+  void destroyNode(NodeBase *base)
+  {
+    Node *node = static_cast<Node*>(base);
+
+    NodeTraits::destroy(nodeAllocator(), node->valuePtr());
+    recycleNode(node);
+  }
+
+  // Destroys the payloads and hands the slabs back, the nodes themselves
+  // need no individual release.
+  void dispose()
+  {
+    for (NodeBase *node = head.next; node != &tail; node = node->next)
+      NodeTraits::destroy(nodeAllocator(), static_cast<Node*>(node)->valuePtr());
+
+    countNodeFrees(length);
+    releasePool();
+
+    head.next = &tail;
+    tail.prev = &head;
+    length = 0;
+  }
+
+  // Makes the sentinels enclose the chain [first, last], which is empty
+  // when first is null.
+  void adopt(NodeBase *first, NodeBase *last)
+  {
+    if (first == nullptr)
+    {
+      head.next = &tail;
+      tail.prev = &head;
+      return;
+    }
+
+    head.next = first;
+    first->prev = &head;
+    tail.prev = last;
+    last->next = &tail;
+  }
+
+  NodeBase* firstNode()
+  {
+    return isEmpty() ? nullptr : head.next;
+  }
+
+  NodeBase* lastNode()
+  {
+    return isEmpty() ? nullptr : tail.prev;
+  }
+
+  void swapPool(LinkedList& other)
+  {
+    using std::swap;
+
+    swap(slabs, other.slabs);
+    swap(lastSlab, other.lastSlab);
+    swap(freeNodes, other.freeNodes);
+    swap(lastFreeNode, other.lastFreeNode);
+    swap(bumpNext, other.bumpNext);
+    swap(bumpEnd, other.bumpEnd);
+    swap(pooledNodes, other.pooledNodes);
+  }
+
+  // Takes over other's nodes together with the slabs holding them,
+  // the list must be empty and own no slabs.
+  void steal(LinkedList& other)
+  {
+    adopt(other.firstNode(), other.lastNode());
+    other.adopt(nullptr, nullptr);
+
+    length = other.length;
+    other.length = 0;
+
+    swapPool(other);
+  }
+
+  // Adds other's slabs and spare nodes to this pool, leaving other with
+  // none. Only valid when both allocators compare equal. The free lists and
+  // slab chains are joined at their tails; only the untouched rest of the
+  // smaller bump region is threaded node by node, which happens at most
+  // once in the life of a node.
+  void mergePool(LinkedList& other)
+  {
+    if (other.slabs == nullptr)
+      return;
+
+    if (bumpEnd - bumpNext < other.bumpEnd - other.bumpNext)
+    {
+      retireBump();
+      bumpNext = other.bumpNext;
+      bumpEnd = other.bumpEnd;
+    }
+    else
+      other.retireBump();
+
+    if (other.freeNodes != nullptr)
+      pushFree(other.freeNodes, other.lastFreeNode);
+
+    header(other.lastSlab)->next = slabs;
+    if (slabs == nullptr)
+      lastSlab = other.lastSlab;
+    slabs = other.slabs;
+    pooledNodes += other.pooledNodes;
+
+    other.slabs = other.lastSlab = nullptr;
+    other.freeNodes = other.lastFreeNode = nullptr;
+    other.bumpNext = other.bumpEnd = nullptr;
+    other.pooledNodes = 0;
+  }
+
+  // Moves the chain [first, last) in front of position, both in this list.
+  // A chain already in front of position, or starting at it, stays put.
+  static void relink(NodeBase *position, NodeBase *first, NodeBase *last)
+  {
+    if (first == last || position == first || position == last)
+      return;
+
+    NodeBase *lastIncluded = last->prev;
+
+    first->prev->next = last;
+    last->prev = first->prev;
+
+    first->prev = position->prev;
+    lastIncluded->next = position;
+    position->prev->next = first;
+    position->prev = lastIncluded;
+  }
+
+  // Moves other's elements one by one in front of position, other ends
+  // up empty. Used when the allocators keep the nodes from changing hands.
+  void transfer(NodeBase *position, LinkedList& other)
+  {
+    while (!other.isEmpty())
+    {
+      linkBefore(position, createNode(std::move(*static_cast<Node*>(other.head.next)->valuePtr())));
+      other.erase(other.begin());
+    }
+  }
+
+  void moveAssign(LinkedList& other, std::true_type)
+  {
+    dispose();
+    nodeAllocator() = other.nodeAllocator();
+    steal(other);
+  }
+
+  // Allocators that do not propagate can only exchange nodes when equal.
+  void moveAssign(LinkedList& other, std::false_type)
+  {
+    if (nodeAllocator() == other.nodeAllocator())
+    {
+      dispose();
+      steal(other);
+      return;
+    }
+
+    dispose();
+    transfer(&tail, other);
+  }
+
+  void swapAllocators(LinkedList& other, std::true_type)
+  {
+    using std::swap;
+    swap(nodeAllocator(), other.nodeAllocator());
+  }
+
+  void swapAllocators(LinkedList&, std::false_type)
+  {}
+
+  void linkBefore(NodeBase *position, NodeBase *temp)
+  {
+    temp->prev = position->prev;
+    temp->next = position;
+
+    position->prev->next = temp;
+    position->prev = temp;
+
+    ++length;
+  }
+
 public:
 
-  LinkedList(): head(nullptr), tail(nullptr), length(0)
+  LinkedList(): LinkedList(allocator_type())
+  {}
+
+  explicit LinkedList(const allocator_type& alloc)
+    : AllocatorStorage<NodeAllocator>(alloc), head(), tail(), length(0),
+      slabs(nullptr), lastSlab(nullptr), freeNodes(nullptr), lastFreeNode(nullptr), bumpNext(nullptr), bumpEnd(nullptr), pooledNodes(0)
   {
-    head = new Node;
-    tail = new Node;
-    head->next = tail;
-    tail->prev = head;
+    head.next = &tail;
+    tail.prev = &head;
   }
 
-  LinkedList(std::initializer_list<Type> l):LinkedList()
+  LinkedList(std::initializer_list<Type> l, const allocator_type& alloc = allocator_type()):LinkedList(alloc)
   {
     for (auto it = l.begin(); it != l.end(); ++it)
       append(*it);
@@ -58,37 +437,41 @@ public:
     //throw std::runtime_error("TODO");
   }
 
-  LinkedList(const LinkedList& other):LinkedList()
+  LinkedList(const LinkedList& other)
+    :LinkedList(allocator_type(NodeTraits::select_on_container_copy_construction(other.nodeAllocator())))
   {
+    reserveNodes(other.length);
     for (auto it = other.begin(); it != other.end(); it++)
       append(*it);
     //(void)other;
     //throw std::runtime_error("TODO");
   }
 
-  LinkedList(LinkedList&& other):LinkedList()
+  LinkedList(LinkedList&& other):LinkedList(allocator_type(other.nodeAllocator()))
   {
-    while (!other.isEmpty())
-    {
-      append(*(other.begin()));
-      other.erase(other.begin());
-    }
+    steal(other);
     //(void)other;
     //throw std::runtime_error("TODO");
   }
 
   ~LinkedList()
   {
-    while (!isEmpty())
-      erase(begin());
-    delete tail;
-    delete head;
+    dispose();
   }
 
   LinkedList& operator=(const LinkedList& other)
   {
-    while (!isEmpty())
-      erase(begin());
+    if (this == &other)
+      return *this;
+
+    clear();
+    if (NodeTraits::propagate_on_container_copy_assignment::value
+        && nodeAllocator() != other.nodeAllocator())
+    {
+      releasePool();
+      nodeAllocator() = other.nodeAllocator();
+    }
+    reserveNodes(other.length);
     for (auto it = other.begin(); it != other.end(); it++)
       append(*it);
 
@@ -99,18 +482,154 @@ public:
 
   LinkedList& operator=(LinkedList&& other)
   {
-    while (!isEmpty())
-      erase(begin());
-    while (!other.isEmpty()) {
-      append(*(other.begin()));
-      other.erase(other.begin());
-    }
+    if (this == &other)
+      return *this;
+
+    moveAssign(other, typename NodeTraits::propagate_on_container_move_assignment());
 
     return *this;
     //(void)other;
     //throw std::runtime_error("TODO");
   }
 
+  allocator_type getAllocator() const
+  {
+    return allocator_type(nodeAllocator());
+  }
+
+  void swap(LinkedList& other)
+  {
+    using std::swap;
+
+    NodeBase *first = firstNode();
+    NodeBase *last = lastNode();
+
+    adopt(other.firstNode(), other.lastNode());
+    other.adopt(first, last);
+
+    swap(length, other.length);
+    swapPool(other);
+    swapAllocators(other, typename NodeTraits::propagate_on_container_swap());
+  }
+
+  // Moves all of other's elements in front of position. The nodes are
+  // relinked and other's slabs join this list's pool, so iterators and
+  // references to the moved elements stay valid and now refer into this
+  // list. With allocators that compare unequal the nodes cannot change
+  // hands: the payloads are moved into new nodes one by one instead, which
+  // may throw and invalidates every iterator into other.
+  void splice(const const_iterator& position, LinkedList& other)
+  {
+    if (this == &other || other.isEmpty())
+      return;
+
+    if (nodeAllocator() != other.nodeAllocator())
+    {
+      transfer(position.pointee, other);
+      return;
+    }
+
+    NodeBase *first = other.head.next;
+    NodeBase *last = other.tail.prev;
+
+    other.adopt(nullptr, nullptr);
+
+    first->prev = position.pointee->prev;
+    last->next = position.pointee;
+    position.pointee->prev->next = first;
+    position.pointee->prev = last;
+
+    length += other.length;
+    other.length = 0;
+
+    mergePool(other);
+  }
+
+  // Moves the element at it in front of position by relinking its node,
+  // iterators and references to it stay valid. Nodes belong to the slabs
+  // of the list that made them, so other must be this list; throws
+  // std::invalid_argument otherwise. Splice a whole list to move elements
+  // between lists.
+  void splice(const const_iterator& position, LinkedList& other, const const_iterator& it)
+  {
+    if (this != &other)
+      throw std::invalid_argument("Only a whole list can be spliced from another list.");
+
+    if (it == end())
+      throw std::out_of_range("Object cannot be spliced.");
+
+    relink(position.pointee, it.pointee, it.pointee->next);
+  }
+
+  // Moves [firstIncluded, lastExcluded) in front of position, which must
+  // not lie inside the range. Same rules as the single element version.
+  void splice(const const_iterator& position, LinkedList& other,
+              const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+  {
+    if (this != &other)
+      throw std::invalid_argument("Only a whole list can be spliced from another list.");
+
+    relink(position.pointee, firstIncluded.pointee, lastExcluded.pointee);
+  }
+
+  // Makes room in the node pool so that the list can hold count elements
+  // without going back to the allocator.
+  void reserveNodes(size_type count)
+  {
+    if (count > pooledNodes)
+      addSlab(count - pooledNodes);
+  }
+
+  // Hands back to the allocator every slab that holds no element.
+  void shrinkToFit()
+  {
+    if (isEmpty())
+    {
+      releasePool();
+      return;
+    }
+
+    retireBump();
+    bumpNext = bumpEnd = nullptr;
+
+    for (Node *slab = slabs; slab != nullptr; slab = header(slab)->next)
+      header(slab)->freeCount = 0;
+
+    for (NodeBase *node = freeNodes; node != nullptr; node = node->next)
+      ++header(slabOf(node))->freeCount;
+
+    NodeBase **link = &freeNodes;
+    lastFreeNode = nullptr;
+    while (*link != nullptr)
+    {
+      Slab *owner = header(slabOf(*link));
+      if (owner->freeCount == owner->capacity)
+        *link = (*link)->next;
+      else
+      {
+        lastFreeNode = *link;
+        link = &(*link)->next;
+      }
+    }
+
+    Node **slabLink = &slabs;
+    lastSlab = nullptr;
+    while (*slabLink != nullptr)
+    {
+      Node *slab = *slabLink;
+      if (header(slab)->freeCount == header(slab)->capacity)
+      {
+        *slabLink = header(slab)->next;
+        releaseSlab(slab);
+      }
+      else
+      {
+        lastSlab = slab;
+        slabLink = &header(slab)->next;
+      }
+    }
+  }
+
   bool isEmpty() const
   {
     return !length;
@@ -123,63 +642,94 @@ public:
     //throw std::runtime_error("TODO");
   }
 
-  void append(const Type& item)
+  // All zero unless AISDI_LINEAR_STATISTICS is 1.
+  using Statistics::getStatistics;
+
+  // Every element takes a whole Node, links and padding included. Pooled
+  // nodes holding no element are slack, each slab spends one more node
+  // on its header.
+  MemoryUsage memoryUsage() const
   {
-    Node *temp = new Node(item);
+    MemoryUsage usage;
+    size_type slabCount = 0;
 
-    temp->prev = tail->prev;
-    temp->next = tail;
+    for (Node *slab = slabs; slab != nullptr; slab = header(slab)->next)
+      ++slabCount;
 
-    tail->prev->next = temp;
-    tail->prev= temp;
+    usage.payload = length * sizeof(Type);
+    usage.links = length * (sizeof(Node) - sizeof(Type));
+    usage.slack = (pooledNodes - length) * sizeof(Node);
+    usage.overhead = sizeof(*this) + slabCount * sizeof(Node);
+    return usage;
+  }
 
-    ++length;
+  // Destroys the elements, their nodes stay pooled for reuse.
+  void clear()
+  {
+    erase(begin(), end());
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
     //(void)item;
     //throw std::runtime_error("TODO");
   }
 
-  void prepend(const Type& item)
+  void append(Type&& item)
   {
-    Node *temp = new Node(item);
-
-    temp->prev = head;
-    temp->next = head->next;
-
-    head->next->prev = temp;
-    head->next= temp;
+    emplaceBack(std::move(item));
+  }
 
-    ++length;
+  void prepend(const Type& item)
+  {
+    emplaceFront(item);
     //(void)item;
     //throw std::runtime_error("TODO");
   }
 
-  void insert(const const_iterator& insertPosition, const Type& item)
+  void prepend(Type&& item)
   {
-    if (insertPosition == begin() )
-      prepend(item);
-    else if (insertPosition == end())
-      append(item);
-    else {
-      Node* temp = new Node(item);
-
-      temp->next = insertPosition.pointee;
-      temp->prev = insertPosition.pointee->prev;
+    emplaceFront(std::move(item));
+  }
 
-      insertPosition.pointee->prev->next = temp;
-      insertPosition.pointee->prev = temp;
-      ++length;
-    }
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
     //(void)insertPosition;
     //(void)item;
     //throw std::runtime_error("TODO");
   }
 
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
+
+  template <typename... Args>
+  void emplaceBack(Args&&... args)
+  {
+    linkBefore(&tail, createNode(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  void emplaceFront(Args&&... args)
+  {
+    linkBefore(head.next, createNode(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  void emplace(const const_iterator& insertPosition, Args&&... args)
+  {
+    linkBefore(insertPosition.pointee, createNode(std::forward<Args>(args)...));
+  }
+
   Type popFirst()
   {
     if (isEmpty())
       throw std::logic_error("Object cannot be popped.");
 
-    Type obj = *begin();
+    Type obj = std::move(*begin());
     erase(begin());
     return obj;
     //throw std::runtime_error("TODO");
@@ -190,7 +740,7 @@ public:
     if (isEmpty())
       throw std::logic_error("Object cannot be popped.");
 
-    Type obj = *(--end());
+    Type obj = std::move(*(--end()));
     erase((--end()));
     return obj;
     //throw std::runtime_error("TODO");
@@ -202,19 +752,43 @@ public:
       throw std::out_of_range("Object cannot be erased.");
     position.pointee->next->prev = position.pointee->prev;
     position.pointee->prev->next = position.pointee->next;
-    delete position.pointee;
+    destroyNode(position.pointee);
     --length;
     //(void)position;
     //throw std::runtime_error("TODO");
   }
 
+  // Cuts the range out with a single relink, then destroys the payloads
+  // and hands the whole chain to the free list at once.
   void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
   {
-    auto it = firstIncluded;
-    while (it != lastExcluded) {
-      it++;
-      erase(it - 1);
+    if (firstIncluded == lastExcluded)
+      return;
+
+    if (firstIncluded == end())
+      throw std::out_of_range("Object cannot be erased.");
+
+    NodeBase *first = firstIncluded.pointee;
+    NodeBase *last = lastExcluded.pointee;
+    NodeBase *node = first;
+
+    first->prev->next = last;
+    last->prev = first->prev;
+
+    size_type count = 0;
+
+    for (;; node = node->next)
+    {
+      NodeTraits::destroy(nodeAllocator(), static_cast<Node*>(node)->valuePtr());
+      ++count;
+
+      if (node->next == last)
+        break;
     }
+
+    length -= count;
+    countNodeFrees(count);
+    pushFree(first, node);
     //(void)firstIncluded;
     //(void)lastExcluded;
     //throw std::runtime_error("TODO");
@@ -222,25 +796,25 @@ public:
 
   iterator begin()
   {
-    return iterator(head->next);
+    return iterator(head.next);
     //throw std::runtime_error("TODO");
   }
 
   iterator end()
   {
-    return iterator(tail);
+    return iterator(&tail);
     //throw std::runtime_error("TODO");
   }
 
   const_iterator cbegin() const
   {
-    return const_iterator(head->next);
+    return const_iterator(head.next);
     //throw std::runtime_error("TODO");
   }
 
   const_iterator cend() const
   {
-    return const_iterator(tail);
+    return const_iterator(const_cast<NodeBase*>(&tail));
     //throw std::runtime_error("TODO");
   }
 
@@ -255,8 +829,8 @@ public:
   }
 };
 
-template <typename Type>
-class LinkedList<Type>::ConstIterator
+template <typename Type, typename Allocator>
+class LinkedList<Type, Allocator>::ConstIterator
 {
 public:
   using iterator_category = std::bidirectional_iterator_tag;
@@ -266,27 +840,30 @@ public:
   using reference = typename LinkedList::const_reference;
 
 private:
-  Node *pointee;
-  friend void LinkedList <Type>::insert(const const_iterator&, const Type&);
-  friend void LinkedList <Type>::erase(const const_iterator&);
+  NodeBase *pointee;
+  friend class LinkedList;
 
 public:
 
-  explicit ConstIterator(Node *pnt = nullptr) : pointee(pnt)
+  explicit ConstIterator(NodeBase *pnt = nullptr) : pointee(pnt)
   {}
 
   reference operator*() const
   {
-    if(pointee->obj == nullptr)
+#if AISDI_CHECKED_ITERATORS
+    if(pointee->next == nullptr)
         throw std::out_of_range("Out of range.");
-    return *(pointee->obj);
+#endif
+    return *static_cast<Node*>(pointee)->valuePtr();
     //throw std::runtime_error("TODO");
   }
 
   ConstIterator& operator++()
   {
+#if AISDI_CHECKED_ITERATORS
     if (pointee->next == nullptr)
         throw std::out_of_range("Out of range.");
+#endif
     pointee = pointee->next;
     return *this;
     //throw std::runtime_error("TODO");
@@ -302,8 +879,10 @@ public:
 
   ConstIterator& operator--()
   {
+#if AISDI_CHECKED_ITERATORS
     if (pointee->prev->prev == nullptr)
         throw std::out_of_range("Out of range.");
+#endif
     pointee = pointee->prev;
     return *this;
     //throw std::runtime_error("TODO");
@@ -352,14 +931,14 @@ public:
   }
 };
 
-template <typename Type> //done
-class LinkedList<Type>::Iterator : public LinkedList<Type>::ConstIterator
+template <typename Type, typename Allocator> //done
+class LinkedList<Type, Allocator>::Iterator : public LinkedList<Type, Allocator>::ConstIterator
 {
 public:
   using pointer = typename LinkedList::pointer;
   using reference = typename LinkedList::reference;
 
-  explicit Iterator(Node *pnt = nullptr): const_iterator(pnt)
+  explicit Iterator(NodeBase *pnt = nullptr): const_iterator(pnt)
   {}
 
   Iterator(const ConstIterator& other)
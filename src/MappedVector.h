@@ -0,0 +1,199 @@
+#ifndef AISDI_LINEAR_MAPPEDVECTOR_H
+#define AISDI_LINEAR_MAPPEDVECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Snapshot.h"
+
+// Indexing is checked and throws std::out_of_range unless
+// AISDI_CHECKED_ITERATORS is 0, which is the default for NDEBUG builds.
+#ifndef AISDI_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define AISDI_CHECKED_ITERATORS 0
+#else
+#define AISDI_CHECKED_ITERATORS 1
+#endif
+#endif
+
+namespace aisdi
+{
+
+// Read-only view of a snapshot written by Vector::saveTo, mapped straight
+// from the file. Opening only checks the header, the elements are paged in
+// when first touched, so the cost of opening does not grow with the size.
+// verify() compares the checksum, reading the whole file. POSIX only.
+template <typename Type>
+class MappedVector
+{
+  static_assert(std::is_trivially_copyable<Type>::value, "Only trivially copyable elements can be mapped");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+  using const_iterator = const Type*;
+
+private:
+  void *mapping;
+  size_type mappedBytes;
+  const Type *elements;
+  size_type length;
+  std::uint64_t checksum;
+
+  void unmap()
+  {
+    if (mapping != nullptr)
+      ::munmap(mapping, mappedBytes);
+  }
+
+public:
+
+  MappedVector() : mapping(nullptr), mappedBytes(0), elements(nullptr), length(0), checksum(0)
+  {}
+
+  // Throws std::runtime_error when the file cannot be mapped or is not a
+  // snapshot of Type elements.
+  explicit MappedVector(const std::string& path) : MappedVector()
+  {
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    struct stat status;
+
+    if (descriptor < 0)
+      throw std::runtime_error("Cannot open " + path + ".");
+
+    if (::fstat(descriptor, &status) != 0 || static_cast<std::uint64_t>(status.st_size) < snapshot::HEADER_BYTES)
+    {
+      ::close(descriptor);
+      throw std::runtime_error("Not a Vector snapshot.");
+    }
+
+    mappedBytes = static_cast<size_type>(status.st_size);
+    mapping = ::mmap(nullptr, mappedBytes, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+
+    if (mapping == MAP_FAILED)
+    {
+      mapping = nullptr;
+      throw std::runtime_error("Cannot map " + path + ".");
+    }
+
+    // The delegating constructor has finished, so the destructor unmaps
+    // the file when the header turns out to be wrong.
+    snapshot::Header header;
+    std::memcpy(&header, mapping, sizeof(header));
+    snapshot::checkHeader<Type>(header, mappedBytes - snapshot::HEADER_BYTES);
+
+    elements = reinterpret_cast<const Type*>(static_cast<const unsigned char*>(mapping) + snapshot::HEADER_BYTES);
+    length = static_cast<size_type>(header.count);
+    checksum = header.checksum;
+  }
+
+  MappedVector(const MappedVector&) = delete;
+  MappedVector& operator=(const MappedVector&) = delete;
+
+  MappedVector(MappedVector&& other) noexcept
+    : mapping(other.mapping), mappedBytes(other.mappedBytes), elements(other.elements),
+      length(other.length), checksum(other.checksum)
+  {
+    other.mapping = nullptr;
+    other.elements = nullptr;
+    other.length = 0;
+  }
+
+  MappedVector& operator=(MappedVector&& other) noexcept
+  {
+    MappedVector moved(std::move(other));
+    swap(moved);
+    return *this;
+  }
+
+  ~MappedVector()
+  {
+    unmap();
+  }
+
+  void swap(MappedVector& other) noexcept
+  {
+    std::swap(mapping, other.mapping);
+    std::swap(mappedBytes, other.mappedBytes);
+    std::swap(elements, other.elements);
+    std::swap(length, other.length);
+    std::swap(checksum, other.checksum);
+  }
+
+  bool isEmpty() const
+  {
+    return !length;
+  }
+
+  size_type getSize() const
+  {
+    return length;
+  }
+
+  // Reads every element, so it faults in the whole file.
+  bool verify() const
+  {
+    return snapshot::checksum(elements, length * sizeof(Type)) == checksum;
+  }
+
+  const Type& operator[](size_type index) const
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (index >= length)
+      throw std::out_of_range("Index out of range.");
+#endif
+
+    return elements[index];
+  }
+
+  const Type& at(size_type index) const
+  {
+    if (index >= length)
+      throw std::out_of_range("Index out of range.");
+
+    return elements[index];
+  }
+
+  const Type* data() const
+  {
+    return elements;
+  }
+
+  const_iterator begin() const
+  {
+    return elements;
+  }
+
+  const_iterator end() const
+  {
+    return elements + length;
+  }
+
+  const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  const_iterator cend() const
+  {
+    return end();
+  }
+};
+
+}
+
+#endif // AISDI_LINEAR_MAPPEDVECTOR_H
@@ -0,0 +1,320 @@
+#ifndef AISDI_LINEAR_PARALLELALGORITHMS_H
+#define AISDI_LINEAR_PARALLELALGORITHMS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "ThreadPool.h"
+#include "Vector.h"
+
+namespace aisdi
+{
+
+// Ranges shorter than sequentialThreshold are processed on the calling
+// thread, longer ones are cut into tasks of about grain elements.
+struct ParallelConfig
+{
+  std::size_t grain = 1 << 16;
+  std::size_t sequentialThreshold = 1 << 17;
+};
+
+namespace detail
+{
+
+inline bool runSequentially(ThreadPool& pool, std::size_t count, const ParallelConfig& config)
+{
+  return count < config.sequentialThreshold || pool.getThreadCount() < 2;
+}
+
+inline std::size_t chunkCount(std::size_t count, const ParallelConfig& config)
+{
+  std::size_t grain = config.grain != 0 ? config.grain : 1;
+  return (count + grain - 1) / grain;
+}
+
+// Calls chunk(index, first, last) for consecutive slices of [0, count),
+// one task each, and waits for all of them.
+template <typename Chunk>
+void forChunks(ThreadPool& pool, std::size_t count, const ParallelConfig& config, Chunk chunk)
+{
+  std::size_t chunks = chunkCount(count, config);
+  TaskGroup group(pool);
+
+  for (std::size_t i = 0; i < chunks; ++i)
+  {
+    std::size_t first = count / chunks * i + std::min(i, count % chunks);
+    std::size_t last = first + count / chunks + (i < count % chunks ? 1 : 0);
+
+    group.run([=, &chunk]() { chunk(i, first, last); });
+  }
+
+  group.wait();
+}
+
+// Number of elements the first d outputs of a stable merge of a and b take
+// from a.
+template <typename Type, typename Compare>
+std::size_t coRank(std::size_t d, const Type *a, std::size_t n, const Type *b, std::size_t m, Compare comp)
+{
+  std::size_t low = d > m ? d - m : 0;
+  std::size_t high = std::min(d, n);
+
+  for (;;)
+  {
+    std::size_t i = low + (high - low) / 2;
+    std::size_t j = d - i;
+
+    if (i > 0 && j < m && comp(b[j], a[i - 1]))
+      high = i - 1;
+    else if (j > 0 && i < n && !comp(b[j - 1], a[i]))
+      low = i + 1;
+    else
+      return i;
+  }
+}
+
+}
+
+template <typename Type, typename Function>
+void forEach(ThreadPool& pool, Type *first, Type *last, Function function,
+             const ParallelConfig& config = ParallelConfig())
+{
+  std::size_t count = last - first;
+
+  if (detail::runSequentially(pool, count, config))
+  {
+    std::for_each(first, last, function);
+    return;
+  }
+
+  detail::forChunks(pool, count, config, [&](std::size_t, std::size_t from, std::size_t to)
+  {
+    std::for_each(first + from, first + to, function);
+  });
+}
+
+// Writes function(source[i]) to destination[i], destination must already
+// hold as many elements as the source range.
+template <typename Input, typename Output, typename Function>
+void transform(ThreadPool& pool, const Input *first, const Input *last, Output *destination, Function function,
+               const ParallelConfig& config = ParallelConfig())
+{
+  std::size_t count = last - first;
+
+  if (detail::runSequentially(pool, count, config))
+  {
+    std::transform(first, last, destination, function);
+    return;
+  }
+
+  detail::forChunks(pool, count, config, [&](std::size_t, std::size_t from, std::size_t to)
+  {
+    std::transform(first + from, first + to, destination + from, function);
+  });
+}
+
+// Folds the range with an associative op. Every chunk is folded from
+// identity in parallel and the chunk results are then folded in order, so
+// identity must be neutral for op and op must take two Results as well.
+template <typename Type, typename Result, typename Operation>
+Result reduce(ThreadPool& pool, const Type *first, const Type *last, Result identity, Operation op,
+              const ParallelConfig& config = ParallelConfig())
+{
+  std::size_t count = last - first;
+
+  if (detail::runSequentially(pool, count, config))
+    return std::accumulate(first, last, identity, op);
+
+  Vector<Result> partial(detail::chunkCount(count, config), identity);
+
+  detail::forChunks(pool, count, config, [&](std::size_t index, std::size_t from, std::size_t to)
+  {
+    partial[index] = std::accumulate(first + from, first + to, identity, op);
+  });
+
+  for (std::size_t i = 0; i < partial.getSize(); ++i)
+    identity = op(std::move(identity), std::move(partial[i]));
+
+  return identity;
+}
+
+template <typename Type, typename Predicate>
+std::size_t countIf(ThreadPool& pool, const Type *first, const Type *last, Predicate predicate,
+                    const ParallelConfig& config = ParallelConfig())
+{
+  std::size_t count = last - first;
+
+  if (detail::runSequentially(pool, count, config))
+    return std::count_if(first, last, predicate);
+
+  Vector<std::size_t> partial(detail::chunkCount(count, config), 0);
+
+  detail::forChunks(pool, count, config, [&](std::size_t index, std::size_t from, std::size_t to)
+  {
+    partial[index] = std::count_if(first + from, first + to, predicate);
+  });
+
+  return std::accumulate(partial.begin(), partial.end(), std::size_t(0));
+}
+
+// Stable merge sort: grain sized runs are sorted in parallel, then merged
+// pairwise level by level. Every merge is cut into grain sized pieces at
+// co-ranks, so even the last merge uses all the threads.
+template <typename Type, typename Compare>
+void sort(ThreadPool& pool, Type *first, Type *last, Compare comp, const ParallelConfig& config = ParallelConfig())
+{
+  std::size_t count = last - first;
+
+  if (detail::runSequentially(pool, count, config))
+  {
+    std::stable_sort(first, last, comp);
+    return;
+  }
+
+  std::size_t grain = config.grain != 0 ? config.grain : 1;
+
+  detail::forChunks(pool, count, config, [&](std::size_t, std::size_t from, std::size_t to)
+  {
+    std::stable_sort(first + from, first + to, comp);
+  });
+
+  // The sorted runs now live in scratch, the first level merges them back.
+  Vector<Type> scratch(std::make_move_iterator(first), std::make_move_iterator(last));
+  Type *source = scratch.data();
+  Type *target = first;
+
+  // run boundaries, the same slices forChunks used
+  Vector<std::size_t> bounds;
+  for (std::size_t i = 0, chunks = detail::chunkCount(count, config); i <= chunks; ++i)
+    bounds.append(count / chunks * i + std::min(i, count % chunks));
+
+  while (bounds.getSize() > 2)
+  {
+    Vector<std::size_t> merged;
+    Vector<std::size_t> pieceStart;
+    Vector<std::size_t> pieceTake;
+    Vector<std::size_t> pieceRun;
+
+    // Pieces are cut before any merge starts moving elements out of source.
+    for (std::size_t r = 0; r + 1 < bounds.getSize(); r += 2)
+    {
+      std::size_t middle = bounds[r + 1];
+      std::size_t end = r + 2 < bounds.getSize() ? bounds[r + 2] : middle;
+      std::size_t pieces = (end - bounds[r] + grain - 1) / grain;
+
+      for (std::size_t p = 0; p < pieces; ++p)
+      {
+        std::size_t outFirst = (end - bounds[r]) / pieces * p;
+
+        pieceStart.append(bounds[r] + outFirst);
+        pieceTake.append(detail::coRank(outFirst, source + bounds[r], middle - bounds[r],
+                                        source + middle, end - middle, comp));
+        pieceRun.append(r);
+      }
+
+      merged.append(bounds[r]);
+    }
+    merged.append(count);
+
+    TaskGroup group(pool);
+
+    for (std::size_t p = 0; p < pieceStart.getSize(); ++p)
+    {
+      group.run([&, p]()
+      {
+        std::size_t r = pieceRun[p];
+        std::size_t begin = bounds[r];
+        std::size_t middle = bounds[r + 1];
+        std::size_t end = r + 2 < bounds.getSize() ? bounds[r + 2] : middle;
+        bool lastPiece = p + 1 == pieceStart.getSize() || pieceRun[p + 1] != r;
+        std::size_t outFirst = pieceStart[p] - begin;
+        std::size_t outLast = (lastPiece ? end : pieceStart[p + 1]) - begin;
+        std::size_t i = pieceTake[p];
+        std::size_t iLast = lastPiece ? middle - begin : pieceTake[p + 1];
+
+        std::merge(std::make_move_iterator(source + begin + i),
+                   std::make_move_iterator(source + begin + iLast),
+                   std::make_move_iterator(source + middle + (outFirst - i)),
+                   std::make_move_iterator(source + middle + (outLast - iLast)),
+                   target + begin + outFirst, comp);
+      });
+    }
+
+    group.wait();
+
+    bounds = std::move(merged);
+    std::swap(source, target);
+  }
+
+  if (source != first)
+    detail::forChunks(pool, count, config, [&](std::size_t, std::size_t from, std::size_t to)
+    {
+      std::move(source + from, source + to, first + from);
+    });
+}
+
+template <typename Type>
+void sort(ThreadPool& pool, Type *first, Type *last, const ParallelConfig& config = ParallelConfig())
+{
+  sort(pool, first, last, std::less<Type>(), config);
+}
+
+// Vector overloads, working on the contiguous storage with no iterator checks.
+
+template <typename Type, typename Allocator, typename GrowthPolicy, std::size_t InlineCapacity, typename Function>
+void forEach(ThreadPool& pool, Vector<Type, Allocator, GrowthPolicy, InlineCapacity>& vector, Function function,
+             const ParallelConfig& config = ParallelConfig())
+{
+  forEach(pool, vector.data(), vector.data() + vector.getSize(), function, config);
+}
+
+template <typename Input, typename InputAllocator, typename InputGrowth, std::size_t InputInline,
+          typename Output, typename OutputAllocator, typename OutputGrowth, std::size_t OutputInline,
+          typename Function>
+void transform(ThreadPool& pool, const Vector<Input, InputAllocator, InputGrowth, InputInline>& source,
+               Vector<Output, OutputAllocator, OutputGrowth, OutputInline>& destination, Function function,
+               const ParallelConfig& config = ParallelConfig())
+{
+  if (destination.getSize() != source.getSize())
+    throw std::invalid_argument("Destination size differs from the source.");
+
+  transform(pool, source.data(), source.data() + source.getSize(), destination.data(), function, config);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, std::size_t InlineCapacity,
+          typename Result, typename Operation>
+Result reduce(ThreadPool& pool, const Vector<Type, Allocator, GrowthPolicy, InlineCapacity>& vector,
+              Result init, Operation op, const ParallelConfig& config = ParallelConfig())
+{
+  return reduce(pool, vector.data(), vector.data() + vector.getSize(), std::move(init), op, config);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, std::size_t InlineCapacity, typename Predicate>
+std::size_t countIf(ThreadPool& pool, const Vector<Type, Allocator, GrowthPolicy, InlineCapacity>& vector,
+                    Predicate predicate, const ParallelConfig& config = ParallelConfig())
+{
+  return countIf(pool, vector.data(), vector.data() + vector.getSize(), predicate, config);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, std::size_t InlineCapacity, typename Compare>
+void sort(ThreadPool& pool, Vector<Type, Allocator, GrowthPolicy, InlineCapacity>& vector, Compare comp,
+          const ParallelConfig& config = ParallelConfig())
+{
+  sort(pool, vector.data(), vector.data() + vector.getSize(), comp, config);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, std::size_t InlineCapacity>
+void sort(ThreadPool& pool, Vector<Type, Allocator, GrowthPolicy, InlineCapacity>& vector,
+          const ParallelConfig& config = ParallelConfig())
+{
+  sort(pool, vector.data(), vector.data() + vector.getSize(), std::less<Type>(), config);
+}
+
+}
+
+#endif // AISDI_LINEAR_PARALLELALGORITHMS_H
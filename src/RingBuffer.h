@@ -0,0 +1,447 @@
+#ifndef AISDI_LINEAR_RINGBUFFER_H
+#define AISDI_LINEAR_RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace aisdi
+{
+
+namespace detail
+{
+
+const std::size_t RING_CACHE_LINE = 64;
+
+// Smallest power of two not below capacity, so positions map to slots
+// with a mask. Throws std::length_error when no such size_t exists.
+inline std::size_t ringCapacity(std::size_t capacity)
+{
+  if (capacity == 0)
+    throw std::invalid_argument("Ring buffer capacity must be positive.");
+  if (capacity > std::numeric_limits<std::size_t>::max() / 2 + 1)
+    throw std::length_error("Ring buffer capacity is too large.");
+
+  std::size_t rounded = 2;
+  while (rounded < capacity)
+    rounded *= 2;
+  return rounded;
+}
+
+}
+
+// Bounded single-producer single-consumer FIFO over one contiguous
+// allocation, storage handled the way Vector does it. Positions only ever
+// grow and are masked into the buffer. Each side keeps a cached copy of
+// the other side's position and reloads it only when the ring looks full
+// or empty, so in the steady state a push or pop touches no shared cache
+// line. Every operation finishes in a bounded number of steps.
+template <typename Type, typename Allocator = std::allocator<Type>>
+class SpscRingBuffer
+{
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using allocator_type = Allocator;
+
+private:
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+  static_assert(std::is_same<typename AllocTraits::pointer, Type*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  // consumer side
+  alignas(detail::RING_CACHE_LINE) std::atomic<size_type> head;
+  size_type cachedTail;
+  // producer side
+  alignas(detail::RING_CACHE_LINE) std::atomic<size_type> tail;
+  size_type cachedHead;
+  // read-only after construction
+  alignas(detail::RING_CACHE_LINE) Allocator allocator;
+  size_type capacity;
+  size_type mask;
+  Type *buffer;
+
+  size_type freeSlots(size_type position)
+  {
+    if (position - cachedHead == capacity)
+      cachedHead = head.load(std::memory_order_acquire);
+    return capacity - (position - cachedHead);
+  }
+
+  size_type readySlots(size_type position)
+  {
+    if (cachedTail == position)
+      cachedTail = tail.load(std::memory_order_acquire);
+    return cachedTail - position;
+  }
+
+public:
+
+  explicit SpscRingBuffer(size_type minCapacity, const allocator_type& alloc = allocator_type())
+    : head(0), cachedTail(0), tail(0), cachedHead(0), allocator(alloc),
+      capacity(detail::ringCapacity(minCapacity)), mask(capacity - 1), buffer(nullptr)
+  {
+    buffer = AllocTraits::allocate(allocator, capacity);
+  }
+
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+  // No other thread may use the ring any more.
+  ~SpscRingBuffer()
+  {
+    for (size_type i = head.load(), end = tail.load(); i != end; ++i)
+      AllocTraits::destroy(allocator, buffer + (i & mask));
+    AllocTraits::deallocate(allocator, buffer, capacity);
+  }
+
+  size_type getCapacity() const
+  {
+    return capacity;
+  }
+
+  // Exact only while neither side is running.
+  size_type getSize() const
+  {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+  }
+
+  // Producer only. False when the ring is full.
+  template <typename... Args>
+  bool tryEmplace(Args&&... args)
+  {
+    size_type position = tail.load(std::memory_order_relaxed);
+
+    if (freeSlots(position) == 0)
+      return false;
+
+    AllocTraits::construct(allocator, buffer + (position & mask), std::forward<Args>(args)...);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPush(const Type& item)
+  {
+    return tryEmplace(item);
+  }
+
+  bool tryPush(Type&& item)
+  {
+    return tryEmplace(std::move(item));
+  }
+
+  // Producer only. Copies as much of the range as fits and publishes it
+  // with a single store, returns the number of elements pushed. Like
+  // MpmcRingBuffer::pushMany, pass std::make_move_iterator to move the
+  // elements instead. Batches always reload the consumer's position.
+  template <typename InputIt>
+  size_type pushMany(InputIt first, InputIt last)
+  {
+    size_type position = tail.load(std::memory_order_relaxed);
+    cachedHead = head.load(std::memory_order_acquire);
+    size_type room = capacity - (position - cachedHead);
+    size_type count = 0;
+
+    try
+    {
+      for (; count < room && first != last; ++first, ++count)
+        AllocTraits::construct(allocator, buffer + ((position + count) & mask), *first);
+    }
+    catch (...)
+    {
+      tail.store(position + count, std::memory_order_release);
+      throw;
+    }
+
+    tail.store(position + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer only. False when the ring is empty.
+  bool tryPop(Type& value)
+  {
+    size_type position = head.load(std::memory_order_relaxed);
+
+    if (readySlots(position) == 0)
+      return false;
+
+    Type *slot = buffer + (position & mask);
+    value = std::move(*slot);
+    AllocTraits::destroy(allocator, slot);
+    head.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Pops up to maxCount elements into out, releasing their
+  // slots with a single store.
+  template <typename OutputIt>
+  size_type popMany(OutputIt out, size_type maxCount)
+  {
+    size_type position = head.load(std::memory_order_relaxed);
+    cachedTail = tail.load(std::memory_order_acquire);
+    size_type ready = cachedTail - position;
+    size_type count = 0;
+
+    if (ready > maxCount)
+      ready = maxCount;
+
+    try
+    {
+      for (; count < ready; ++count)
+      {
+        Type *slot = buffer + ((position + count) & mask);
+        *out++ = std::move(*slot);
+        AllocTraits::destroy(allocator, slot);
+      }
+    }
+    catch (...)
+    {
+      head.store(position + count, std::memory_order_release);
+      throw;
+    }
+
+    head.store(position + count, std::memory_order_release);
+    return count;
+  }
+};
+
+// Bounded multi-producer multi-consumer FIFO, Vyukov's sequenced slots.
+// Every slot carries a sequence number telling which lap and which side
+// may use it next. A producer claims a position by moving tail forward
+// and publishes the element by bumping the slot's sequence, consumers do
+// the same on head. A slot that was claimed has to be published, so
+// elements are built before claiming and moved in afterwards, which
+// needs a nothrow move constructor.
+template <typename Type, typename Allocator = std::allocator<Type>>
+class MpmcRingBuffer
+{
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using allocator_type = Allocator;
+
+  static_assert(std::is_nothrow_move_constructible<Type>::value,
+                "MpmcRingBuffer needs a nothrow move constructible type");
+
+private:
+  struct Slot
+  {
+    std::atomic<size_type> sequence;
+    typename std::aligned_storage<sizeof(Type), alignof(Type)>::type storage;
+    Type* valuePtr() {return reinterpret_cast<Type*>(&storage);}
+  };
+
+  using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+  using SlotTraits = std::allocator_traits<SlotAllocator>;
+
+  static_assert(std::is_same<typename SlotTraits::pointer, Slot*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  alignas(detail::RING_CACHE_LINE) std::atomic<size_type> head;
+  alignas(detail::RING_CACHE_LINE) std::atomic<size_type> tail;
+  alignas(detail::RING_CACHE_LINE) SlotAllocator allocator;
+  size_type capacity;
+  size_type mask;
+  Slot *slots;
+
+  static std::ptrdiff_t lag(size_type sequence, size_type expected)
+  {
+    return static_cast<std::ptrdiff_t>(sequence - expected);
+  }
+
+  // Claims up to maxCount consecutive positions of cursor whose slots all
+  // hold sequence position + offset. Returns the first claimed position
+  // through position and the number claimed, 0 when none is available.
+  size_type claim(std::atomic<size_type>& cursor, size_type offset, size_type maxCount, size_type& position)
+  {
+    position = cursor.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+      std::ptrdiff_t behind = lag(slots[position & mask].sequence.load(std::memory_order_acquire), position + offset);
+
+      if (behind < 0)
+        return 0;
+
+      if (behind > 0)
+      {
+        position = cursor.load(std::memory_order_relaxed);
+        continue;
+      }
+
+      size_type count = 1;
+      while (count < maxCount
+             && slots[(position + count) & mask].sequence.load(std::memory_order_acquire) == position + count + offset)
+        ++count;
+
+      // nobody else claims those slots unless cursor moves past position
+      if (cursor.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+        return count;
+    }
+  }
+
+  // Must not throw, a claimed slot cannot be given back.
+  template <typename Source>
+  void publish(size_type position, Source&& item)
+  {
+    Slot& slot = slots[position & mask];
+    SlotTraits::construct(allocator, slot.valuePtr(), std::forward<Source>(item));
+    slot.sequence.store(position + 1, std::memory_order_release);
+  }
+
+  // The slot is released before the element reaches out, so a throwing
+  // assignment cannot leave it claimed.
+  template <typename OutputIt>
+  void consume(size_type position, OutputIt& out)
+  {
+    Slot& slot = slots[position & mask];
+    Type item(std::move(*slot.valuePtr()));
+    SlotTraits::destroy(allocator, slot.valuePtr());
+    slot.sequence.store(position + capacity, std::memory_order_release);
+    *out++ = std::move(item);
+  }
+
+  // Drops claimed elements nobody can take any more.
+  void discard(size_type position, size_type count)
+  {
+    for (size_type i = 0; i < count; ++i)
+    {
+      Slot& slot = slots[(position + i) & mask];
+      SlotTraits::destroy(allocator, slot.valuePtr());
+      slot.sequence.store(position + i + capacity, std::memory_order_release);
+    }
+  }
+
+public:
+
+  explicit MpmcRingBuffer(size_type minCapacity, const allocator_type& alloc = allocator_type())
+    : head(0), tail(0), allocator(alloc),
+      capacity(detail::ringCapacity(minCapacity)), mask(capacity - 1), slots(nullptr)
+  {
+    slots = SlotTraits::allocate(allocator, capacity);
+    for (size_type i = 0; i < capacity; ++i)
+      ::new (static_cast<void*>(&slots[i].sequence)) std::atomic<size_type>(i);
+  }
+
+  MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+  MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+  // No other thread may use the ring any more.
+  ~MpmcRingBuffer()
+  {
+    for (size_type i = head.load(), end = tail.load(); i != end; ++i)
+      SlotTraits::destroy(allocator, slots[i & mask].valuePtr());
+    SlotTraits::deallocate(allocator, slots, capacity);
+  }
+
+  size_type getCapacity() const
+  {
+    return capacity;
+  }
+
+  // Exact only while no thread is running.
+  size_type getSize() const
+  {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+  }
+
+  template <typename... Args>
+  bool tryEmplace(Args&&... args)
+  {
+    Type item(std::forward<Args>(args)...);
+    size_type position;
+
+    if (claim(tail, 0, 1, position) == 0)
+      return false;
+
+    publish(position, std::move(item));
+    return true;
+  }
+
+  bool tryPush(const Type& item)
+  {
+    return tryEmplace(item);
+  }
+
+  bool tryPush(Type&& item)
+  {
+    return tryEmplace(std::move(item));
+  }
+
+  // Claims as many consecutive slots as are free, up to the length of the
+  // range, with a single CAS and copies the elements in, as
+  // SpscRingBuffer::pushMany does; pass std::make_move_iterator to move
+  // them instead. Returns the number of elements pushed. Constructing a
+  // Type from *first must not throw, and random access iterators are
+  // needed because the count must be known before claiming.
+  template <typename RandomIt>
+  size_type pushMany(RandomIt first, RandomIt last)
+  {
+    static_assert(std::is_nothrow_constructible<Type, typename std::iterator_traits<RandomIt>::reference>::value,
+                  "Elements whose copy may throw must be pushed through std::make_move_iterator");
+
+    size_type wanted = static_cast<size_type>(last - first);
+    size_type position;
+
+    if (wanted == 0)
+      return 0;
+
+    size_type count = claim(tail, 0, wanted, position);
+
+    for (size_type i = 0; i < count; ++i)
+      publish(position + i, first[i]);
+
+    return count;
+  }
+
+  bool tryPop(Type& value)
+  {
+    size_type position;
+
+    if (claim(head, 1, 1, position) == 0)
+      return false;
+
+    Type *out = &value;
+    consume(position, out);
+    return true;
+  }
+
+  // Claims up to maxCount consecutive ready slots with a single CAS and
+  // pops them into out. If writing to out throws, the rest of the claimed
+  // elements are lost.
+  template <typename OutputIt>
+  size_type popMany(OutputIt out, size_type maxCount)
+  {
+    size_type position;
+
+    if (maxCount == 0)
+      return 0;
+
+    size_type count = claim(head, 1, maxCount, position);
+    size_type done = 0;
+
+    try
+    {
+      for (; done < count; ++done)
+        consume(position + done, out);
+    }
+    catch (...)
+    {
+      discard(position + done + 1, count - done - 1);
+      throw;
+    }
+
+    return count;
+  }
+};
+
+}
+
+#endif // AISDI_LINEAR_RINGBUFFER_H
@@ -0,0 +1,201 @@
+#ifndef AISDI_LINEAR_SNAPSHOT_H
+#define AISDI_LINEAR_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace aisdi
+{
+
+// File format of Vector::saveTo, read by Vector::loadFrom and MappedVector.
+// A HEADER_BYTES long header is followed by the raw bytes of the elements,
+// so a mapped file can be used in place by anything aligned to at most
+// HEADER_BYTES. Snapshots are only readable on machines with the same byte
+// order and element layout.
+namespace snapshot
+{
+
+const char MAGIC[8] = {'A', 'I', 'S', 'D', 'I', 'V', 'E', 'C'};
+const std::uint32_t VERSION = 1;
+const std::uint32_t ENDIAN_TAG = 0x01020304;
+const std::size_t HEADER_BYTES = 64;
+
+struct Header
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endianTag;
+  std::uint32_t typeSize;
+  std::uint32_t typeAlignment;
+  std::uint64_t count;
+  std::uint64_t checksum;
+};
+
+static_assert(sizeof(Header) <= HEADER_BYTES, "Header must fit before the elements");
+
+// FNV-1a over 64-bit words in four interleaved lanes, so hashing runs at
+// memory speed rather than at the latency of one multiply per word.
+inline std::uint64_t checksum(const void *data, std::size_t bytes)
+{
+  const std::uint64_t prime = 0x100000001b3ull;
+  std::uint64_t lanes[4] = {0xcbf29ce484222325ull, 0x84222325cbf29ce4ull,
+                            0xcbf29ce484222325ull ^ 1, 0x84222325cbf29ce4ull ^ 1};
+  const unsigned char *bytesIn = static_cast<const unsigned char*>(data);
+  std::size_t i = 0;
+
+  for (; i + 32 <= bytes; i += 32)
+    for (std::size_t lane = 0; lane < 4; ++lane)
+    {
+      std::uint64_t word;
+      std::memcpy(&word, bytesIn + i + lane * 8, 8);
+      lanes[lane] = (lanes[lane] ^ word) * prime;
+    }
+
+  std::uint64_t hash = lanes[0];
+  for (std::size_t lane = 1; lane < 4; ++lane)
+    hash = (hash ^ lanes[lane]) * prime;
+
+  for (; i < bytes; ++i)
+    hash = (hash ^ bytesIn[i]) * prime;
+
+  return (hash ^ bytes) * prime;
+}
+
+template <typename Type>
+Header makeHeader(std::size_t count, std::uint64_t sum)
+{
+  Header header;
+
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.endianTag = ENDIAN_TAG;
+  header.typeSize = sizeof(Type);
+  header.typeAlignment = alignof(Type);
+  header.count = count;
+  header.checksum = sum;
+  return header;
+}
+
+// Throws std::runtime_error unless the header describes a snapshot of
+// Type elements whose payload is exactly the available bytes.
+template <typename Type>
+void checkHeader(const Header& header, std::uint64_t payloadBytes)
+{
+  static_assert(alignof(Type) <= HEADER_BYTES, "Type is aligned stricter than a snapshot allows");
+
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    throw std::runtime_error("Not a Vector snapshot.");
+  if (header.version != VERSION || header.endianTag != ENDIAN_TAG)
+    throw std::runtime_error("Unsupported Vector snapshot version or byte order.");
+  if (header.typeSize != sizeof(Type) || header.typeAlignment != alignof(Type))
+    throw std::runtime_error("Vector snapshot holds a different element type.");
+  if (header.count > payloadBytes / sizeof(Type))
+    throw std::runtime_error("Vector snapshot is truncated.");
+  if (header.count * sizeof(Type) != payloadBytes)
+    throw std::runtime_error("Vector snapshot has trailing bytes.");
+}
+
+// std::FILE closed on destruction; every failure throws std::runtime_error.
+class File
+{
+  std::FILE *handle;
+  std::string path;
+
+public:
+
+  File(const std::string& filePath, const char *mode) : handle(std::fopen(filePath.c_str(), mode)), path(filePath)
+  {
+    if (handle == nullptr)
+      throw std::runtime_error("Cannot open " + path + ".");
+  }
+
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  ~File()
+  {
+    if (handle != nullptr)
+      std::fclose(handle);
+  }
+
+  void write(const void *data, std::size_t bytes)
+  {
+    if (bytes != 0 && std::fwrite(data, 1, bytes, handle) != bytes)
+      throw std::runtime_error("Cannot write " + path + ".");
+  }
+
+  void read(void *data, std::size_t bytes)
+  {
+    if (bytes != 0 && std::fread(data, 1, bytes, handle) != bytes)
+      throw std::runtime_error("Cannot read " + path + ".");
+  }
+
+  std::uint64_t size()
+  {
+    long position = std::ftell(handle);
+    long end = -1;
+
+    if (position >= 0 && std::fseek(handle, 0, SEEK_END) == 0)
+      end = std::ftell(handle);
+    if (end < 0 || std::fseek(handle, position, SEEK_SET) != 0)
+      throw std::runtime_error("Cannot read " + path + ".");
+
+    return static_cast<std::uint64_t>(end);
+  }
+
+  // Reports write errors that only show up when the buffer is flushed.
+  void close()
+  {
+    std::FILE *closed = handle;
+
+    handle = nullptr;
+    if (std::fclose(closed) != 0)
+      throw std::runtime_error("Cannot write " + path + ".");
+  }
+};
+
+// Writes to a temporary file renamed over path once complete, so a crash
+// halfway through leaves the previous snapshot intact.
+template <typename Type>
+void save(const std::string& path, const Type *elements, std::size_t count)
+{
+  static_assert(std::is_trivially_copyable<Type>::value, "Only trivially copyable elements can be saved");
+
+  const std::size_t bytes = count * sizeof(Type);
+  const std::string temporary = path + ".tmp";
+  unsigned char header[HEADER_BYTES] = {};
+  Header fields = makeHeader<Type>(count, checksum(elements, bytes));
+
+  std::memcpy(header, &fields, sizeof(fields));
+
+  try
+  {
+    File file(temporary, "wb");
+    file.write(header, sizeof(header));
+    file.write(elements, bytes);
+    file.close();
+  }
+  catch (...)
+  {
+    std::remove(temporary.c_str());
+    throw;
+  }
+
+  if (std::rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Cannot replace " + path + ".");
+  }
+}
+
+}
+
+}
+
+#endif // AISDI_LINEAR_SNAPSHOT_H
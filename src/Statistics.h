@@ -0,0 +1,240 @@
+#ifndef AISDI_LINEAR_STATISTICS_H
+#define AISDI_LINEAR_STATISTICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+
+// Containers count their allocations, reallocations, shifted elements and
+// node traffic when AISDI_LINEAR_STATISTICS is 1. It is 0 by default, and
+// then the counters are empty bases whose calls compile to nothing.
+#ifndef AISDI_LINEAR_STATISTICS
+#define AISDI_LINEAR_STATISTICS 0
+#endif
+
+namespace aisdi
+{
+
+// Counted since the container was created; copies and moved-to
+// containers start from zero. bytesAllocated adds up every allocation,
+// freed or not. peakCapacity counts element slots: the buffer for Vector,
+// pooled nodes for LinkedList and CompactList, live nodes for IndexedList.
+// UnrolledList leaves it at zero.
+struct ContainerStatistics
+{
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytesAllocated = 0;
+  std::size_t reallocations = 0;
+  std::size_t elementsShifted = 0;
+  std::size_t nodeAllocations = 0;
+  std::size_t nodeFrees = 0;
+  std::size_t peakCapacity = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& out, const ContainerStatistics& statistics)
+{
+  return out << "allocations:     " << statistics.allocations << "\n"
+             << "deallocations:   " << statistics.deallocations << "\n"
+             << "bytesAllocated:  " << statistics.bytesAllocated << "\n"
+             << "reallocations:   " << statistics.reallocations << "\n"
+             << "elementsShifted: " << statistics.elementsShifted << "\n"
+             << "nodeAllocations: " << statistics.nodeAllocations << "\n"
+             << "nodeFrees:       " << statistics.nodeFrees << "\n"
+             << "peakCapacity:    " << statistics.peakCapacity << "\n";
+}
+
+// Bytes a container holds, the container object included. payload is
+// the live elements, links the per element bookkeeping of node based
+// containers, slack the capacity allocated but unused, overhead the rest.
+// Memory the elements allocate themselves is not seen.
+struct MemoryUsage
+{
+  std::size_t payload = 0;
+  std::size_t links = 0;
+  std::size_t slack = 0;
+  std::size_t overhead = 0;
+
+  std::size_t total() const
+  {
+    return payload + links + slack + overhead;
+  }
+};
+
+// Sum over every container in the program, peakCapacity is the largest
+// any single one reached. Updated with relaxed atomics, so a snapshot
+// taken while other threads work is only approximate.
+class GlobalStatistics
+{
+  struct Counters
+  {
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> deallocations{0};
+    std::atomic<std::size_t> bytesAllocated{0};
+    std::atomic<std::size_t> reallocations{0};
+    std::atomic<std::size_t> elementsShifted{0};
+    std::atomic<std::size_t> nodeAllocations{0};
+    std::atomic<std::size_t> nodeFrees{0};
+    std::atomic<std::size_t> peakCapacity{0};
+  };
+
+  template <bool Enabled>
+  friend class StatisticsCounter;
+
+  static Counters& counters()
+  {
+    static Counters global;
+    return global;
+  }
+
+  static void add(std::atomic<std::size_t>& counter, std::size_t amount)
+  {
+    counter.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  static void raise(std::atomic<std::size_t>& counter, std::size_t value)
+  {
+    std::size_t seen = counter.load(std::memory_order_relaxed);
+
+    while (value > seen && !counter.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+      ;
+  }
+
+public:
+
+  static ContainerStatistics snapshot()
+  {
+    Counters& global = counters();
+    ContainerStatistics statistics;
+
+    statistics.allocations = global.allocations.load(std::memory_order_relaxed);
+    statistics.deallocations = global.deallocations.load(std::memory_order_relaxed);
+    statistics.bytesAllocated = global.bytesAllocated.load(std::memory_order_relaxed);
+    statistics.reallocations = global.reallocations.load(std::memory_order_relaxed);
+    statistics.elementsShifted = global.elementsShifted.load(std::memory_order_relaxed);
+    statistics.nodeAllocations = global.nodeAllocations.load(std::memory_order_relaxed);
+    statistics.nodeFrees = global.nodeFrees.load(std::memory_order_relaxed);
+    statistics.peakCapacity = global.peakCapacity.load(std::memory_order_relaxed);
+    return statistics;
+  }
+
+  static void reset()
+  {
+    Counters& global = counters();
+
+    global.allocations = 0;
+    global.deallocations = 0;
+    global.bytesAllocated = 0;
+    global.reallocations = 0;
+    global.elementsShifted = 0;
+    global.nodeAllocations = 0;
+    global.nodeFrees = 0;
+    global.peakCapacity = 0;
+  }
+
+  static void dump(std::ostream& out)
+  {
+    out << snapshot();
+  }
+};
+
+// Private base of every container. Counters belong to the object, so
+// copying or assigning a container leaves them alone.
+template <bool Enabled>
+class StatisticsCounter
+{
+  ContainerStatistics statistics;
+
+  using Global = GlobalStatistics;
+
+protected:
+
+  StatisticsCounter() = default;
+
+  StatisticsCounter(const StatisticsCounter&)
+  {}
+
+  StatisticsCounter& operator=(const StatisticsCounter&)
+  {
+    return *this;
+  }
+
+  void countAllocation(std::size_t bytes)
+  {
+    ++statistics.allocations;
+    statistics.bytesAllocated += bytes;
+    Global::add(Global::counters().allocations, 1);
+    Global::add(Global::counters().bytesAllocated, bytes);
+  }
+
+  void countDeallocation()
+  {
+    ++statistics.deallocations;
+    Global::add(Global::counters().deallocations, 1);
+  }
+
+  void countReallocation()
+  {
+    ++statistics.reallocations;
+    Global::add(Global::counters().reallocations, 1);
+  }
+
+  void countShift(std::size_t elements)
+  {
+    statistics.elementsShifted += elements;
+    Global::add(Global::counters().elementsShifted, elements);
+  }
+
+  void countNodeAllocation()
+  {
+    ++statistics.nodeAllocations;
+    Global::add(Global::counters().nodeAllocations, 1);
+  }
+
+  void countNodeFrees(std::size_t count)
+  {
+    statistics.nodeFrees += count;
+    Global::add(Global::counters().nodeFrees, count);
+  }
+
+  void countCapacity(std::size_t capacity)
+  {
+    if (capacity > statistics.peakCapacity)
+      statistics.peakCapacity = capacity;
+    Global::raise(Global::counters().peakCapacity, capacity);
+  }
+
+public:
+
+  ContainerStatistics getStatistics() const
+  {
+    return statistics;
+  }
+};
+
+template <>
+class StatisticsCounter<false>
+{
+protected:
+
+  void countAllocation(std::size_t) {}
+  void countDeallocation() {}
+  void countReallocation() {}
+  void countShift(std::size_t) {}
+  void countNodeAllocation() {}
+  void countNodeFrees(std::size_t) {}
+  void countCapacity(std::size_t) {}
+
+public:
+
+  ContainerStatistics getStatistics() const
+  {
+    return ContainerStatistics();
+  }
+};
+
+using Statistics = StatisticsCounter<AISDI_LINEAR_STATISTICS != 0>;
+
+}
+
+#endif // AISDI_LINEAR_STATISTICS_H
@@ -0,0 +1,262 @@
+#ifndef AISDI_LINEAR_THREADPOOL_H
+#define AISDI_LINEAR_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aisdi
+{
+
+// Fixed set of worker threads with one task deque each. A worker pushes
+// and pops its own tasks at the back and, when it runs dry, steals from
+// the front of the others. Tasks submitted from outside the pool are
+// dealt round robin. Threads waiting on a TaskGroup run pending tasks
+// meanwhile, so tasks may wait for the tasks they spawn.
+class ThreadPool
+{
+public:
+  using size_type = std::size_t;
+  using Task = std::function<void()>;
+
+private:
+  struct Worker
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+  std::atomic<size_type> pending;
+  std::atomic<size_type> nextWorker;
+  bool stopping;
+
+  // Index of the calling thread's worker in the pool it belongs to.
+  static ThreadPool*& currentPool()
+  {
+    static thread_local ThreadPool *pool = nullptr;
+    return pool;
+  }
+
+  static size_type& currentIndex()
+  {
+    static thread_local size_type index = 0;
+    return index;
+  }
+
+  bool popOwn(size_type index, Task& task)
+  {
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+
+    if (worker.tasks.empty())
+      return false;
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+  }
+
+  bool steal(size_type thief, Task& task)
+  {
+    for (size_type i = 1; i <= workers.size(); ++i)
+    {
+      Worker& victim = *workers[(thief + i) % workers.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+
+      if (victim.tasks.empty())
+        continue;
+
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+
+    return false;
+  }
+
+  bool takeTask(Task& task)
+  {
+    size_type index = currentPool() == this ? currentIndex() : nextWorker.load() % workers.size();
+
+    if (!popOwn(index, task) && !steal(index, task))
+      return false;
+
+    --pending;
+    return true;
+  }
+
+  void work(size_type index)
+  {
+    currentPool() = this;
+    currentIndex() = index;
+
+    Task task;
+
+    for (;;)
+    {
+      if (takeTask(task))
+      {
+        task();
+        task = nullptr;
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      wakeUp.wait(lock, [this] { return stopping || pending.load() != 0; });
+
+      if (stopping && pending.load() == 0)
+        return;
+    }
+  }
+
+public:
+
+  static size_type defaultThreadCount()
+  {
+    size_type count = std::thread::hardware_concurrency();
+    return count != 0 ? count : 1;
+  }
+
+  explicit ThreadPool(size_type threadCount = defaultThreadCount())
+    : pending(0), nextWorker(0), stopping(false)
+  {
+    if (threadCount == 0)
+      threadCount = 1;
+
+    for (size_type i = 0; i < threadCount; ++i)
+      workers.emplace_back(new Worker);
+
+    for (size_type i = 0; i < threadCount; ++i)
+      threads.emplace_back(&ThreadPool::work, this, i);
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Finishes every submitted task before joining the workers.
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+  size_type getThreadCount() const
+  {
+    return threads.size();
+  }
+
+  void submit(Task task)
+  {
+    size_type index = currentPool() == this ? currentIndex() : nextWorker++ % workers.size();
+
+    // counted first so that taking the task never sees pending at zero
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      ++pending;
+    }
+
+    {
+      Worker& worker = *workers[index];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.tasks.push_back(std::move(task));
+    }
+
+    wakeUp.notify_one();
+  }
+
+  // Runs one pending task on the calling thread, if there is any.
+  bool runPendingTask()
+  {
+    Task task;
+
+    if (!takeTask(task))
+      return false;
+
+    task();
+    return true;
+  }
+};
+
+// Tracks a batch of tasks submitted to a pool. wait() helps running
+// pending tasks until the whole batch is done and rethrows the first
+// exception one of them threw.
+class TaskGroup
+{
+  ThreadPool& pool;
+  std::atomic<std::size_t> unfinished;
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+public:
+
+  explicit TaskGroup(ThreadPool& threadPool) : pool(threadPool), unfinished(0)
+  {}
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  ~TaskGroup()
+  {
+    while (unfinished.load() != 0)
+      if (!pool.runPendingTask())
+        std::this_thread::yield();
+  }
+
+  template <typename Function>
+  void run(Function function)
+  {
+    ++unfinished;
+
+    pool.submit([this, function]()
+    {
+      try
+      {
+        function();
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+      }
+      --unfinished;
+    });
+  }
+
+  void wait()
+  {
+    while (unfinished.load() != 0)
+      if (!pool.runPendingTask())
+        std::this_thread::yield();
+
+    if (error)
+    {
+      std::exception_ptr thrown = error;
+      error = nullptr;
+      std::rethrow_exception(thrown);
+    }
+  }
+};
+
+}
+
+#endif // AISDI_LINEAR_THREADPOOL_H
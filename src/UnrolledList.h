@@ -0,0 +1,784 @@
+#ifndef AISDI_LINEAR_UNROLLEDLIST_H
+#define AISDI_LINEAR_UNROLLEDLIST_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "AllocatorStorage.h"
+#include "Statistics.h"
+
+// With AISDI_CHECKED_ITERATORS set (the default unless NDEBUG) iterators
+// throw std::out_of_range when moved or dereferenced out of the list.
+#ifndef AISDI_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define AISDI_CHECKED_ITERATORS 0
+#else
+#define AISDI_CHECKED_ITERATORS 1
+#endif
+#endif
+
+namespace aisdi
+{
+
+// Default number of elements per UnrolledList node, about 512 bytes of
+// payload but never fewer than 8 elements.
+template <typename Type>
+struct UnrolledNodeCapacity
+{
+  static constexpr std::size_t value = 512 / sizeof(Type) < 8 ? 8 : 512 / sizeof(Type);
+};
+
+namespace detail
+{
+
+// The sentinel is a plain UnrolledListNodeBase, always with count 0.
+struct UnrolledListNodeBase
+{
+  UnrolledListNodeBase *prev;
+  UnrolledListNodeBase *next;
+  std::size_t count;
+  UnrolledListNodeBase(): prev(this), next(this), count(0){}
+};
+
+template <typename Type, std::size_t NodeCapacity>
+struct UnrolledListNode : UnrolledListNodeBase
+{
+  typename std::aligned_storage<sizeof(Type), alignof(Type)>::type slots[NodeCapacity];
+  Type* slot(std::size_t index) {return reinterpret_cast<Type*>(&slots[index]);}
+};
+
+}
+
+// A doubly linked list of nodes holding up to NodeCapacity elements each,
+// stored contiguously. Scanning touches one link per node instead of one
+// per element; inserting or erasing only shifts elements within a node.
+// A full node is split in half, a node left under half full is merged with
+// its successor when they fit together.
+template <typename Type, typename Allocator = std::allocator<Type>,
+          std::size_t NodeCapacity = UnrolledNodeCapacity<Type>::value>
+class UnrolledList : private AllocatorStorage<ReboundAllocator<Allocator, detail::UnrolledListNode<Type, NodeCapacity>>>,
+                     private Statistics
+{
+  static_assert(NodeCapacity >= 2, "Nodes must hold at least two elements");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using allocator_type = Allocator;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  using NodeBase = detail::UnrolledListNodeBase;
+  using Node = detail::UnrolledListNode<Type, NodeCapacity>;
+
+private:
+  using NodeAllocator = ReboundAllocator<Allocator, Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  static_assert(std::is_same<typename NodeTraits::pointer, Node*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  NodeAllocator& nodeAllocator()
+  {
+    return this->storedAllocator();
+  }
+
+  const NodeAllocator& nodeAllocator() const
+  {
+    return this->storedAllocator();
+  }
+
+  NodeBase sentinel;
+  size_type length;
+
+  static Type* slot(NodeBase *node, size_type index)
+  {
+    return static_cast<Node*>(node)->slot(index);
+  }
+
+  template <typename... Args>
+  void construct(Type *position, Args&&... args)
+  {
+    NodeTraits::construct(nodeAllocator(), position, std::forward<Args>(args)...);
+  }
+
+  void destroy(Type *position)
+  {
+    NodeTraits::destroy(nodeAllocator(), position);
+  }
+
+  void moveSlot(NodeBase *to, size_type toIndex, NodeBase *from, size_type fromIndex)
+  {
+    construct(slot(to, toIndex), std::move(*slot(from, fromIndex)));
+    destroy(slot(from, fromIndex));
+  }
+
+  // Links an empty node after position.
+  NodeBase* createNodeAfter(NodeBase *position)
+  {
+    Node *node = NodeTraits::allocate(nodeAllocator(), 1);
+
+    countAllocation(sizeof(Node));
+    countNodeAllocation();
+    node->count = 0;
+    node->prev = position;
+    node->next = position->next;
+    position->next->prev = node;
+    position->next = node;
+
+    return node;
+  }
+
+  void destroyNode(NodeBase *node)
+  {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+
+    for (size_type i = 0; i < node->count; ++i)
+      destroy(slot(node, i));
+
+    NodeTraits::deallocate(nodeAllocator(), static_cast<Node*>(node), 1);
+    countDeallocation();
+    countNodeFrees(1);
+  }
+
+  // Moves node's elements from index on count slots to the right, leaving
+  // the gap as raw memory. The node must have room for them.
+  void openGap(NodeBase *node, size_type index, size_type count)
+  {
+    countShift(node->count - index);
+    for (size_type i = node->count; i-- > index;)
+      moveSlot(node, i + count, node, i);
+  }
+
+  // Closes a gap of count raw slots at index.
+  void closeGap(NodeBase *node, size_type index, size_type count)
+  {
+    countShift(node->count - index);
+    for (size_type i = index + count; i < node->count + count; ++i)
+      moveSlot(node, i - count, node, i);
+  }
+
+  // Moves the upper half of a full node into a new node after it.
+  NodeBase* split(NodeBase *node)
+  {
+    NodeBase *upper = createNodeAfter(node);
+    size_type half = node->count / 2;
+
+    for (size_type i = half; i < node->count; ++i)
+      moveSlot(upper, i - half, node, i);
+
+    upper->count = node->count - half;
+    node->count = half;
+
+    return upper;
+  }
+
+  // Places value at (node, index), making room as needed. Returns the
+  // position the element ended up at.
+  std::pair<NodeBase*, size_type> place(NodeBase *node, size_type index, Type&& value)
+  {
+    if (node == &sentinel || (index == 0 && node->count == NodeCapacity))
+    {
+      // prefer the end of the previous node, a fresh node otherwise
+      NodeBase *previous = node->prev;
+
+      if (previous == &sentinel || previous->count == NodeCapacity)
+        previous = createNodeAfter(previous);
+
+      node = previous;
+      index = node->count;
+    }
+    else if (node->count == NodeCapacity)
+    {
+      NodeBase *upper = split(node);
+
+      if (index > node->count)
+      {
+        index -= node->count;
+        node = upper;
+      }
+    }
+
+    openGap(node, index, 1);
+
+    try
+    {
+      construct(slot(node, index), std::move(value));
+    }
+    catch (...)
+    {
+      closeGap(node, index, 1);
+      if (node->count == 0)
+        destroyNode(node);
+      throw;
+    }
+
+    ++node->count;
+    ++length;
+
+    return std::make_pair(node, index);
+  }
+
+  // Erases count elements from (node, index), all within that node, and
+  // returns the position of the element that followed them.
+  std::pair<NodeBase*, size_type> eraseInNode(NodeBase *node, size_type index, size_type count)
+  {
+    for (size_type i = index; i < index + count; ++i)
+      destroy(slot(node, i));
+
+    node->count -= count;
+    length -= count;
+    closeGap(node, index, count);
+
+    NodeBase *next = node->next;
+
+    if (node->count == 0)
+    {
+      destroyNode(node);
+      return std::make_pair(next, 0);
+    }
+
+    if (node->count < NodeCapacity / 2 && next != &sentinel && node->count + next->count <= NodeCapacity)
+    {
+      for (size_type i = 0; i < next->count; ++i)
+        moveSlot(node, node->count + i, next, i);
+
+      node->count += next->count;
+      next->count = 0;
+      destroyNode(next);
+    }
+
+    if (index == node->count)
+      return std::make_pair(node->next, 0);
+
+    return std::make_pair(node, index);
+  }
+
+  // Takes over the chain [first, last], or becomes empty for nullptr.
+  void adopt(NodeBase *first, NodeBase *last)
+  {
+    if (first == nullptr)
+    {
+      sentinel.prev = sentinel.next = &sentinel;
+      return;
+    }
+
+    sentinel.next = first;
+    sentinel.prev = last;
+    first->prev = &sentinel;
+    last->next = &sentinel;
+  }
+
+  void steal(UnrolledList& other)
+  {
+    NodeBase *first = other.sentinel.next;
+    NodeBase *last = other.sentinel.prev;
+
+    if (first == &other.sentinel)
+      return;
+
+    adopt(first, last);
+    length = other.length;
+
+    other.adopt(nullptr, nullptr);
+    other.length = 0;
+  }
+
+  void moveAssign(UnrolledList& other, std::true_type)
+  {
+    clear();
+    nodeAllocator() = std::move(other.nodeAllocator());
+    steal(other);
+  }
+
+  void moveAssign(UnrolledList& other, std::false_type)
+  {
+    clear();
+
+    if (nodeAllocator() == other.nodeAllocator())
+    {
+      steal(other);
+      return;
+    }
+
+    for (auto it = other.begin(); it != other.end(); ++it)
+      emplaceBack(std::move(*it));
+    other.clear();
+  }
+
+  void swapAllocators(UnrolledList& other, std::true_type)
+  {
+    using std::swap;
+    swap(nodeAllocator(), other.nodeAllocator());
+  }
+
+  void swapAllocators(UnrolledList&, std::false_type)
+  {}
+
+public:
+
+  UnrolledList(): UnrolledList(allocator_type())
+  {}
+
+  explicit UnrolledList(const allocator_type& alloc)
+    : AllocatorStorage<NodeAllocator>(alloc), sentinel(), length(0)
+  {}
+
+  UnrolledList(std::initializer_list<Type> l, const allocator_type& alloc = allocator_type()):UnrolledList(alloc)
+  {
+    for (auto it = l.begin(); it != l.end(); ++it)
+      append(*it);
+  }
+
+  UnrolledList(const UnrolledList& other)
+    :UnrolledList(allocator_type(NodeTraits::select_on_container_copy_construction(other.nodeAllocator())))
+  {
+    for (auto it = other.begin(); it != other.end(); ++it)
+      append(*it);
+  }
+
+  UnrolledList(UnrolledList&& other):UnrolledList(allocator_type(other.nodeAllocator()))
+  {
+    steal(other);
+  }
+
+  ~UnrolledList()
+  {
+    clear();
+  }
+
+  UnrolledList& operator=(const UnrolledList& other)
+  {
+    if (this == &other)
+      return *this;
+
+    clear();
+    if (NodeTraits::propagate_on_container_copy_assignment::value)
+      nodeAllocator() = other.nodeAllocator();
+    for (auto it = other.begin(); it != other.end(); ++it)
+      append(*it);
+
+    return *this;
+  }
+
+  UnrolledList& operator=(UnrolledList&& other)
+  {
+    if (this == &other)
+      return *this;
+
+    moveAssign(other, typename NodeTraits::propagate_on_container_move_assignment());
+
+    return *this;
+  }
+
+  allocator_type getAllocator() const
+  {
+    return allocator_type(nodeAllocator());
+  }
+
+  void swap(UnrolledList& other)
+  {
+    using std::swap;
+
+    NodeBase *first = isEmpty() ? nullptr : sentinel.next;
+    NodeBase *last = sentinel.prev;
+
+    adopt(other.isEmpty() ? nullptr : other.sentinel.next, other.sentinel.prev);
+    other.adopt(first, last);
+
+    swap(length, other.length);
+    swapAllocators(other, typename NodeTraits::propagate_on_container_swap());
+  }
+
+  bool isEmpty() const
+  {
+    return !length;
+  }
+
+  size_type getSize() const
+  {
+    return length;
+  }
+
+  // All zero unless AISDI_LINEAR_STATISTICS is 1.
+  using Statistics::getStatistics;
+
+  // Free slots in the nodes are slack, walks the nodes to count them.
+  MemoryUsage memoryUsage() const
+  {
+    MemoryUsage usage;
+    size_type nodes = 0;
+
+    for (const NodeBase *node = sentinel.next; node != &sentinel; node = node->next)
+      ++nodes;
+
+    usage.payload = length * sizeof(Type);
+    usage.links = nodes * (sizeof(Node) - NodeCapacity * sizeof(Type));
+    usage.slack = (nodes * NodeCapacity - length) * sizeof(Type);
+    usage.overhead = sizeof(*this);
+    return usage;
+  }
+
+  void clear()
+  {
+    while (sentinel.next != &sentinel)
+      destroyNode(sentinel.next);
+
+    length = 0;
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
+  }
+
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
+  void prepend(const Type& item)
+  {
+    emplaceFront(item);
+  }
+
+  void prepend(Type&& item)
+  {
+    emplaceFront(std::move(item));
+  }
+
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
+  }
+
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
+
+  template <typename... Args>
+  void emplaceBack(Args&&... args)
+  {
+    NodeBase *last = sentinel.prev;
+
+    if (last == &sentinel || last->count == NodeCapacity)
+    {
+      Type value(std::forward<Args>(args)...);
+      place(&sentinel, 0, std::move(value));
+      return;
+    }
+
+    construct(slot(last, last->count), std::forward<Args>(args)...);
+    ++last->count;
+    ++length;
+  }
+
+  template <typename... Args>
+  void emplaceFront(Args&&... args)
+  {
+    emplace(cbegin(), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void emplace(const const_iterator& insertPosition, Args&&... args)
+  {
+    // args may refer to an element that is about to move
+    Type value(std::forward<Args>(args)...);
+
+    place(insertPosition.node, insertPosition.index, std::move(value));
+  }
+
+  Type popFirst()
+  {
+    if (isEmpty())
+      throw std::logic_error("Object cannot be popped.");
+
+    Type obj = std::move(*begin());
+    erase(begin());
+    return obj;
+  }
+
+  Type popLast()
+  {
+    if (isEmpty())
+      throw std::logic_error("Object cannot be popped.");
+
+    NodeBase *last = sentinel.prev;
+    Type obj = std::move(*slot(last, last->count - 1));
+
+    eraseInNode(last, last->count - 1, 1);
+    return obj;
+  }
+
+  void erase(const const_iterator& position)
+  {
+    if (position.node == &sentinel)
+      throw std::out_of_range("Object cannot be erased.");
+
+    eraseInNode(position.node, position.index, 1);
+  }
+
+  // Erases node by node, shifting each touched node once.
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+  {
+    size_type remaining = 0;
+
+    for (auto it = firstIncluded; it != lastExcluded; ++it)
+      ++remaining;
+
+    NodeBase *node = firstIncluded.node;
+    size_type index = firstIncluded.index;
+
+    while (remaining != 0)
+    {
+      size_type count = node->count - index < remaining ? node->count - index : remaining;
+      auto next = eraseInNode(node, index, count);
+
+      remaining -= count;
+      node = next.first;
+      index = next.second;
+    }
+  }
+
+  iterator begin()
+  {
+    return iterator(sentinel.next, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(&sentinel, 0);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(sentinel.next, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(const_cast<NodeBase*>(&sentinel), 0);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+};
+
+template <typename Type, typename Allocator, std::size_t NodeCapacity>
+class UnrolledList<Type, Allocator, NodeCapacity>::ConstIterator
+{
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename UnrolledList::value_type;
+  using difference_type = typename UnrolledList::difference_type;
+  using pointer = typename UnrolledList::const_pointer;
+  using reference = typename UnrolledList::const_reference;
+
+private:
+  NodeBase *node;
+  size_type index;
+  friend class UnrolledList;
+
+public:
+
+  explicit ConstIterator(NodeBase *pnt = nullptr, size_type idx = 0) : node(pnt), index(idx)
+  {}
+
+  reference operator*() const
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (node->count == 0)
+        throw std::out_of_range("Out of range.");
+#endif
+    return *slot(node, index);
+  }
+
+  ConstIterator& operator++()
+  {
+#if AISDI_CHECKED_ITERATORS
+    if (node->count == 0)
+        throw std::out_of_range("Out of range.");
+#endif
+    if (++index == node->count)
+    {
+      node = node->next;
+      index = 0;
+    }
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    auto result = *this;
+    operator++();
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+    if (index == 0)
+    {
+#if AISDI_CHECKED_ITERATORS
+      if (node->prev->count == 0)
+          throw std::out_of_range("Out of range.");
+#endif
+      node = node->prev;
+      index = node->count;
+    }
+    --index;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    auto result = *this;
+    operator--();
+    return result;
+  }
+
+  // Skips whole nodes, so the cost is O(d / NodeCapacity) hops.
+  ConstIterator operator+(difference_type d) const
+  {
+    if (d < 0)
+      return *this - (-d);
+
+    auto result = *this;
+    size_type left = static_cast<size_type>(d);
+
+    while (left >= result.node->count - result.index)
+    {
+#if AISDI_CHECKED_ITERATORS
+      if (result.node->count == 0 && left != 0)
+          throw std::out_of_range("Out of range.");
+#endif
+      if (result.node->count == 0)
+        return result;
+      left -= result.node->count - result.index;
+      result.node = result.node->next;
+      result.index = 0;
+    }
+
+    result.index += left;
+    return result;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    if (d < 0)
+      return *this + (-d);
+
+    auto result = *this;
+    size_type left = static_cast<size_type>(d);
+
+    while (left > result.index)
+    {
+#if AISDI_CHECKED_ITERATORS
+      if (result.node->prev->count == 0)
+          throw std::out_of_range("Out of range.");
+#endif
+      left -= result.index;
+      result.node = result.node->prev;
+      result.index = result.node->count;
+    }
+
+    result.index -= left;
+    return result;
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return node == other.node && index == other.index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+template <typename Type, typename Allocator, std::size_t NodeCapacity>
+class UnrolledList<Type, Allocator, NodeCapacity>::Iterator
+  : public UnrolledList<Type, Allocator, NodeCapacity>::ConstIterator
+{
+public:
+  using pointer = typename UnrolledList::pointer;
+  using reference = typename UnrolledList::reference;
+
+  explicit Iterator(NodeBase *pnt = nullptr, size_type idx = 0): ConstIterator(pnt, idx)
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+};
+
+template <typename Type>
+constexpr std::size_t UnrolledNodeCapacity<Type>::value;
+
+}
+
+#endif // AISDI_LINEAR_UNROLLEDLIST_H
@@ -1,160 +1,935 @@
 #ifndef AISDI_LINEAR_VECTOR_H
 #define AISDI_LINEAR_VECTOR_H
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
-
-#define S_CAP 10
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "AllocatorStorage.h"
+#include "Snapshot.h"
+#include "Statistics.h"
+
+// Iterators check their bounds and throw std::out_of_range unless
+// AISDI_CHECKED_ITERATORS is 0, which is the default for NDEBUG builds.
+// Unchecked iterators are plain pointer wrappers with no branches.
+#ifndef AISDI_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define AISDI_CHECKED_ITERATORS 0
+#else
+#define AISDI_CHECKED_ITERATORS 1
+#endif
+#endif
 
 namespace aisdi
 {
 
+// Growth policies pick the capacity of the next buffer from the current
+// capacity and the number of elements that must fit in it.
+template <std::size_t Numerator, std::size_t Denominator, std::size_t Initial = 10>
+struct GeometricGrowth
+{
+  static_assert(Numerator > Denominator, "Growth factor must be greater than one");
+
+  static std::size_t grow(std::size_t capacity, std::size_t required)
+  {
+    std::size_t next = capacity < Initial ? Initial
+                                          : capacity + capacity / Denominator * (Numerator - Denominator);
+
+    return next < required ? required : next;
+  }
+};
+
+using DoublingGrowth = GeometricGrowth<2, 1>;
+using OneAndHalfGrowth = GeometricGrowth<3, 2>;
+
+// Grows by a constant number of slots, trading more reallocations for
+// a bounded amount of unused capacity.
+template <std::size_t Chunk>
+struct ChunkGrowth
+{
+  static_assert(Chunk > 0, "Chunk must not be empty");
+
+  static std::size_t grow(std::size_t capacity, std::size_t required)
+  {
+    std::size_t next = capacity + Chunk;
+
+    return next < required ? required : next;
+  }
+};
+
+// Types for which moving an object to a new address and forgetting the old
+// one is equivalent to copying its bytes. Vector shifts and regrows such
+// types with memmove/memcpy. Specialize it for types that are not trivially
+// copyable but do not hold pointers into themselves.
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type>
+{};
+
+// Room for Capacity elements inside the object itself, see SmallVector.
+template <typename Type, std::size_t Capacity>
+class InlineStorage
+{
+  typename std::aligned_storage<sizeof(Type) * Capacity, alignof(Type)>::type storage;
+
+protected:
+  Type* inlineBuffer()
+  {
+    return reinterpret_cast<Type*>(&storage);
+  }
+
+  const Type* inlineBuffer() const
+  {
+    return reinterpret_cast<const Type*>(&storage);
+  }
+};
+
 template <typename Type>
-class Vector
+class InlineStorage<Type, 0>
+{
+protected:
+  Type* inlineBuffer() const
+  {
+    return nullptr;
+  }
+};
+
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth,
+          std::size_t InlineCapacity = 0>
+class Vector : private InlineStorage<Type, InlineCapacity>, private AllocatorStorage<Allocator>, private Statistics
 {
 public:
   using difference_type = std::ptrdiff_t;
   using size_type = std::size_t;
   using value_type = Type;
+  using allocator_type = Allocator;
   using pointer = Type*;
   using reference = Type&;
   using const_pointer = const Type*;
   using const_reference = const Type&;
 
-  class ConstIterator;
-  class Iterator;
-  using iterator = Iterator;
-  using const_iterator = ConstIterator;
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+private:
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+  static_assert(std::is_same<typename AllocTraits::value_type, Type>::value,
+                "Allocator::value_type must be the element type");
+  static_assert(std::is_same<typename AllocTraits::pointer, Type*>::value,
+                "Allocators with fancy pointers are not supported");
+
+  size_type length;
+  size_type capacity;
+  Type *buffer;
+  Type *head;
+  Type *tail;
+
+  using Relocatable = std::integral_constant<bool, IsTriviallyRelocatable<Type>::value>;
+
+  // Whether the contents may be moved around inside the buffer without
+  // risking an exception halfway through.
+  using Slidable = std::integral_constant<bool, Relocatable::value
+                                                || (std::is_nothrow_move_constructible<Type>::value
+                                                    && std::is_nothrow_move_assignable<Type>::value)>;
+
+  allocator_type& allocator()
+  {
+    return this->storedAllocator();
+  }
+
+  const allocator_type& allocator() const
+  {
+    return this->storedAllocator();
+  }
+
+  // Storage is raw memory: only [head, tail) holds constructed objects,
+  // the slack on both sides of it in [buffer, buffer + capacity) is left
+  // uninitialized. Slack in front lets prepend and popFirst work without
+  // shifting the whole contents.
+  Type* allocate(size_type count)
+  {
+    Type *storage = AllocTraits::allocate(allocator(), count);
+
+    countAllocation(count * sizeof(Type));
+    countCapacity(count);
+    return storage;
+  }
+
+  void deallocate(Type *storage, size_type count)
+  {
+    if(storage != this->inlineBuffer())
+    {
+      AllocTraits::deallocate(allocator(), storage, count);
+      countDeallocation();
+    }
+  }
+
+  bool isInline() const
+  {
+    return InlineCapacity != 0 && buffer == this->inlineBuffer();
+  }
+
+  template <typename... Args>
+  void construct(Type *position, Args&&... args)
+  {
+    AllocTraits::construct(allocator(), position, std::forward<Args>(args)...);
+  }
+
+  void destroy(Type *first, Type *last)
+  {
+    for(; first != last; ++first)
+      AllocTraits::destroy(allocator(), first);
+  }
+
+  // Releases the whole buffer, leaving the object to be reinitialised.
+  void release()
+  {
+    if(buffer == nullptr)
+      return;
+
+    destroy(head, tail);
+    deallocate(buffer, capacity);
+  }
+
+  // The empty state owns no heap buffer, only the inline one if any.
+  void reset()
+  {
+    length = 0;
+    capacity = InlineCapacity;
+    buffer = tail = head = this->inlineBuffer();
+  }
+
+  Type* storageEnd() const
+  {
+    return buffer + capacity;
+  }
+
+  // Once empty the vector starts over from the front of its buffer.
+  void rewindIfEmpty()
+  {
+    if(isEmpty())
+      tail = head = buffer;
+  }
+
+  // Constructs copies of [first, last) at dest, moving instead when
+  // Type's move constructor cannot throw. On failure nothing is left alive.
+  Type* uninitializedMove(Type *first, Type *last, Type *dest)
+  {
+    Type *i = dest;
+
+    try
+    {
+      for(; first != last; ++first, ++i)
+        construct(i, std::move_if_noexcept(*first));
+    }
+    catch(...)
+    {
+      destroy(dest, i);
+      throw;
+    }
+
+    return i;
+  }
+
+  Type* uninitializedRelocate(Type *first, Type *last, Type *dest, std::true_type)
+  {
+    if(first != last)
+      std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first),
+                  (last - first) * sizeof(Type));
+
+    return dest + (last - first);
+  }
+
+  Type* uninitializedRelocate(Type *first, Type *last, Type *dest, std::false_type)
+  {
+    return uninitializedMove(first, last, dest);
+  }
+
+  // Ends the lifetime of a range left behind by uninitializedRelocate.
+  // Relocatable types are moved bytewise, bypassing allocator construct/destroy.
+  void destroyRelocated(Type*, Type*, std::true_type)
+  {}
+
+  void destroyRelocated(Type *first, Type *last, std::false_type)
+  {
+    destroy(first, last);
+  }
+
+  void shiftLeft(Type *to, Type *from, Type *end, std::true_type)
+  {
+    destroy(to, from);
+
+    if(from != end)
+      std::memmove(static_cast<void*>(to), static_cast<const void*>(from),
+                   (end - from) * sizeof(Type));
+  }
+
+  void shiftLeft(Type *to, Type *from, Type *end, std::false_type)
+  {
+    Type *i = to;
+
+    for(; from != end; ++i, ++from)
+      *i = std::move(*from);
+
+    destroy(i, end);
+  }
+
+  // Leaves position as raw memory.
+  void shiftRight(Type *position, Type *end, std::true_type)
+  {
+    std::memmove(static_cast<void*>(position + 1), static_cast<const void*>(position),
+                 (end - position) * sizeof(Type));
+  }
+
+  // Leaves position holding a moved-from object.
+  void shiftRight(Type *position, Type *end, std::false_type)
+  {
+    construct(end, std::move(*(end - 1)));
+
+    for(Type *i = end - 1; i != position; --i)
+      *i = std::move(*(i - 1));
+  }
+
+  // Fills the slot opened by r_move (or by openFront when fromFront).
+  void fillShifted(Type *position, Type&& value, bool fromFront, std::true_type)
+  {
+    try
+    {
+      construct(position, std::move(value));
+    }
+    catch(...)
+    {
+      if(fromFront)
+      {
+        std::memmove(static_cast<void*>(head + 1), static_cast<const void*>(head),
+                     (position - head) * sizeof(Type));
+        ++head;
+      }
+      else
+      {
+        std::memmove(static_cast<void*>(position), static_cast<const void*>(position + 1),
+                     (tail - position - 1) * sizeof(Type));
+        --tail;
+      }
+      throw;
+    }
+  }
+
+  void fillShifted(Type *position, Type&& value, bool, std::false_type)
+  {
+    *position = std::move(value);
+  }
+
+  // Moves [head, position) one slot to the left, position - 1 is left as
+  // r_move leaves its slot.
+  void openFront(Type *position)
+  {
+    countShift(position - head);
+    openFront(position, Relocatable());
+
+    --head;
+  }
+
+  void openFront(Type *position, std::true_type)
+  {
+    std::memmove(static_cast<void*>(head - 1), static_cast<const void*>(head),
+                 (position - head) * sizeof(Type));
+  }
+
+  void openFront(Type *position, std::false_type)
+  {
+    construct(head - 1, std::move(*head));
+
+    for(Type *i = head; i + 1 < position; ++i)
+      *i = std::move(*(i + 1));
+  }
+
+  // Erases [first, last) by moving [head, first) to the right.
+  void closeFront(Type *first, Type *last)
+  {
+    countShift(first - head);
+    closeFront(first, last, Relocatable());
+
+    head += last - first;
+  }
+
+  void closeFront(Type *first, Type *last, std::true_type)
+  {
+    destroy(first, last);
+
+    if(head != first)
+      std::memmove(static_cast<void*>(head + (last - first)), static_cast<const void*>(head),
+                   (first - head) * sizeof(Type));
+  }
+
+  void closeFront(Type *first, Type *last, std::false_type)
+  {
+    std::move_backward(head, first, last);
+    destroy(head, head + (last - first));
+  }
+
+  // Moves the contents within the buffer so that they start at newHead.
+  void slide(Type *newHead)
+  {
+    if(newHead != head)
+    {
+      countShift(length);
+      slide(newHead, Relocatable());
+    }
+
+    head = newHead;
+    tail = newHead + length;
+  }
+
+  void slide(Type *newHead, std::true_type)
+  {
+    std::memmove(static_cast<void*>(newHead), static_cast<const void*>(head), length * sizeof(Type));
+  }
+
+  void slide(Type *newHead, std::false_type)
+  {
+    Type *newTail = newHead + length;
+
+    if(newHead < head)
+    {
+      Type *to = newHead;
+
+      for(Type *from = head; from != tail; ++from, ++to)
+      {
+        if(to < head)
+          construct(to, std::move(*from));
+        else
+          *to = std::move(*from);
+      }
+
+      destroy(newTail > head ? newTail : head, tail);
+    }
+    else
+    {
+      Type *to = newTail;
+
+      for(Type *from = tail; from != head;)
+      {
+        --from;
+        --to;
+
+        if(to >= tail)
+          construct(to, std::move(*from));
+        else
+          *to = std::move(*from);
+      }
+
+      destroy(head, newHead < tail ? newHead : tail);
+    }
+  }
+
+  // When one end is full but the other has at least half as much slack as
+  // there are elements, moving the contents to the middle of the buffer is
+  // cheaper than reallocating and keeps both ends amortized O(1).
+  bool canCentre() const
+  {
+    size_type slack = capacity - length;
+
+    return Slidable::value && slack != 0 && 2 * slack >= length;
+  }
+
+  void centre(bool forFront)
+  {
+    size_type slack = capacity - length;
+
+    slide(buffer + (forFront ? (slack + 1) / 2 : slack / 2));
+  }
+
+void l_move(Type *to, Type *from)
+  {
+    countShift(tail - from);
+    shiftLeft(to, from, tail, Relocatable());
+
+    tail -= from - to;
+  }
+
+void r_move(Type *position)
+  {
+    if(position == tail)
+      return;
+
+    countShift(tail - position);
+    shiftRight(position, tail, Relocatable());
+
+    ++tail;
+  }
+
+  // Moves the contents into a buffer of newCapacity slots leaving a gap
+  // of count slots at position. fill constructs the gap's elements before
+  // the old buffer is released (they may be copied from it) and either
+  // succeeds or throws leaving nothing constructed.
+  // The new contents start offset slots into the new buffer.
+  template <typename Fill>
+  void reallocateWithGap(Type *position, size_type count, size_type newCapacity, size_type offset, Fill fill)
+  {
+    Type *temp;
+
+    // shrinking back into the inline buffer
+    if(newCapacity <= InlineCapacity && !isInline())
+    {
+      temp = this->inlineBuffer();
+      newCapacity = InlineCapacity;
+    }
+    else
+      temp = allocate(newCapacity);
+
+    Type *newHead = temp + offset;
+    Type *slot = newHead + (position - head);
+    Type *i = newHead;
+
+    try
+    {
+      fill(slot);
+
+      try
+      {
+        i = uninitializedRelocate(head, position, newHead, Relocatable());
+        i = uninitializedRelocate(position, tail, slot + count, Relocatable());
+      }
+      catch(...)
+      {
+        if(i != newHead)
+          destroy(newHead, i);
+        destroy(slot, slot + count);
+        throw;
+      }
+    }
+    catch(...)
+    {
+      deallocate(temp, newCapacity);
+      throw;
+    }
+
+    destroyRelocated(head, tail, Relocatable());
+    if(buffer != nullptr)
+    {
+      deallocate(buffer, capacity);
+      countReallocation();
+    }
+
+    buffer = temp;
+    head = newHead;
+    tail = i;
+    capacity = newCapacity;
+  }
+
+  // When the free slots only sit on the wrong side of the contents the
+  // buffer needs to grow just if they are scarce.
+  size_type nextCapacity(size_type required) const
+  {
+    if(required <= capacity && 2 * (capacity - length) >= length)
+      return capacity;
+
+    return GrowthPolicy::grow(capacity, required);
+  }
+
+  // Growing at the front puts all the new slack in front of the contents.
+  template <typename... Args>
+  void reallocInsert(Type *position, bool atFront, Args&&... args)
+  {
+    size_type newCapacity = nextCapacity(length + 1);
+
+    reallocateWithGap(position, 1, newCapacity, atFront ? newCapacity - length - 1 : 0,
+                      [&](Type *slot) { construct(slot, std::forward<Args>(args)...); });
+  }
+
+  // Moves the contents into a buffer of exactly newCapacity slots.
+  void reallocate(size_type newCapacity)
+  {
+    reallocateWithGap(tail, 0, newCapacity, 0, [](Type*) {});
+  }
+
+  template <typename Iterator>
+  using BitwiseCopyable = std::integral_constant<bool, std::is_trivially_copyable<Type>::value
+                                                       && (std::is_same<Iterator, Type*>::value
+                                                           || std::is_same<Iterator, const Type*>::value)>;
+
+  template <typename InputIt>
+  Type* uninitializedCopy(InputIt first, InputIt last, Type *dest)
+  {
+    return uninitializedCopy(first, last, dest, BitwiseCopyable<InputIt>());
+  }
+
+  Type* uninitializedCopy(const Type *first, const Type *last, Type *dest, std::true_type)
+  {
+    if(first != last)
+      std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first),
+                  (last - first) * sizeof(Type));
+
+    return dest + (last - first);
+  }
+
+  template <typename InputIt>
+  Type* uninitializedCopy(InputIt first, InputIt last, Type *dest, std::false_type)
+  {
+    Type *i = dest;
+
+    try
+    {
+      for(; first != last; ++first, ++i)
+        construct(i, *first);
+    }
+    catch(...)
+    {
+      destroy(dest, i);
+      throw;
+    }
+
+    return i;
+  }
+
+  template <typename InputIt>
+  void assignRange(InputIt first, InputIt last, std::input_iterator_tag)
+  {
+    clear();
+
+    for(; first != last; ++first)
+      emplaceBack(*first);
+  }
+
+  template <typename ForwardIt>
+  void assignRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+  {
+    size_type count = std::distance(first, last);
+
+    if(count > capacity)
+    {
+      Type *temp = allocate(count);
+
+      try
+      {
+        uninitializedCopy(first, last, temp);
+      }
+      catch(...)
+      {
+        deallocate(temp, count);
+        throw;
+      }
+
+      release();
+
+      buffer = head = temp;
+      tail = temp + count;
+      capacity = count;
+    }
+    else if(count <= length)
+    {
+      Type *end = std::copy(first, last, head);
+
+      destroy(end, tail);
+      tail = end;
+    }
+    else if(count <= static_cast<size_type>(storageEnd() - head))
+    {
+      ForwardIt mid = first;
+      std::advance(mid, length);
+
+      std::copy(first, mid, head);
+      tail = uninitializedCopy(mid, last, tail);
+    }
+    else
+    {
+      clear();
+      tail = uninitializedCopy(first, last, head);
+    }
+
+    length = count;
+  }
+
+  template <typename InputIt>
+  void insertRange(Type *position, InputIt first, InputIt last, std::input_iterator_tag)
+  {
+    size_type offset = position - head;
+
+    for(; first != last; ++first, ++offset)
+      emplace(const_iterator(head + offset, *this), *first);
+  }
+
+  template <typename ForwardIt>
+  void insertRange(Type *position, ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+  {
+    size_type count = std::distance(first, last);
+
+    if(count == 0)
+      return;
+
+    bool backRoom = count <= static_cast<size_type>(storageEnd() - tail);
+
+    if(length + count > capacity || (!backRoom && !Slidable::value))
+      reallocateWithGap(position, count, nextCapacity(length + count), 0,
+                        [&](Type *slot) { uninitializedCopy(first, last, slot); });
+    else
+    {
+      if(!backRoom)
+      {
+        size_type offset = position - head;
+
+        slide(buffer);
+        position = head + offset;
+      }
+
+      countShift(tail - position);
+      insertInPlace(position, first, last, count, Relocatable());
+    }
+
+    length += count;
+  }
+
+  template <typename ForwardIt>
+  void insertInPlace(Type *position, ForwardIt first, ForwardIt last, size_type count, std::true_type)
+  {
+    size_type after = tail - position;
+
+    std::memmove(static_cast<void*>(position + count), static_cast<const void*>(position),
+                 after * sizeof(Type));
+
+    try
+    {
+      uninitializedCopy(first, last, position);
+    }
+    catch(...)
+    {
+      std::memmove(static_cast<void*>(position), static_cast<const void*>(position + count),
+                   after * sizeof(Type));
+      throw;
+    }
+
+    tail += count;
+  }
+
+  template <typename ForwardIt>
+  void insertInPlace(Type *position, ForwardIt first, ForwardIt last, size_type count, std::false_type)
+  {
+    size_type after = tail - position;
+    Type *end = tail;
+
+    try
+    {
+      if(after > count)
+      {
+        tail = uninitializedMove(end - count, end, end);
+        std::move_backward(position, end - count, end);
+        std::copy(first, last, position);
+      }
+      else
+      {
+        ForwardIt mid = first;
+        std::advance(mid, after);
+
+        tail = uninitializedCopy(mid, last, end);
+        tail = uninitializedMove(position, end, tail);
+        std::copy(first, mid, position);
+      }
+    }
+    catch(...)
+    {
+      // Elements constructed past the old end stay, only partly assigned
+      // ones may hold moved-from values. The caller's length += count is
+      // skipped, so count exactly what is alive.
+      length = tail - head;
+      throw;
+    }
+  }
+
+  // Takes over other's buffer and leaves it empty. Elements in other's
+  // inline buffer have to be moved over one by one.
+  void steal(Vector& other)
+  {
+    if(other.isInline())
+    {
+      reset();
+      tail = uninitializedMove(other.head, other.tail, head);
+      length = other.length;
+      other.clear();
+      return;
+    }
+
+    length = other.length;
+    capacity = other.capacity;
 
-private:
-  size_type length;
-  size_type capacity;
-  Type *head;
-  Type *tail;
+    buffer = other.buffer;
+    head = other.head;
+    tail = other.tail;
+
+    other.reset();
+  }
 
-void l_move(const const_iterator& position_to, const const_iterator& position_from)
+  void propagate(const Vector& other, std::true_type)
   {
-    iterator to = iterator(position_to.pointee, *this);
-    const_iterator from = position_from;
+    allocator() = other.allocator();
+  }
 
-    for(; from != cend(); ++to, ++from)
-      *to = *from;
+  void propagate(const Vector&, std::false_type)
+  {}
 
-    tail = to.pointee;
+  void moveAssign(Vector& other, std::true_type)
+  {
+    release();
+    propagate(other, typename AllocTraits::propagate_on_container_move_assignment());
+    steal(other);
   }
 
-void r_move(const const_iterator& position)
+  // Allocators that do not propagate can only exchange buffers when equal.
+  void moveAssign(Vector& other, std::false_type)
   {
-    if(isEmpty())
+    if(allocator() == other.allocator())
     {
-      ++tail;
+      moveAssign(other, std::true_type());
       return;
     }
 
-    iterator it = end() - 1;
-
-    ++tail;
+    clear();
 
-    for(; it != position; --it)
-      *(it+1) = *it;
+    for(Type *i = other.head; i != other.tail; ++i)
+      emplaceBack(std::move(*i));
 
-    *(it+1) = *it;
+    other.clear();
   }
 
-Type* resize()
+  void swapAllocators(Vector& other, std::true_type)
   {
-    if(length + 1 <= capacity)
-      return NULL;
-
-    capacity = 2 * length;
-
-    return new Type[capacity];
+    using std::swap;
+    swap(allocator(), other.allocator());
   }
 
+  void swapAllocators(Vector&, std::false_type)
+  {}
+
 public:
 
-  Vector():length(0), capacity(S_CAP)
+  Vector():Vector(allocator_type())
+  {}
+
+  explicit Vector(const allocator_type& alloc)
+    :AllocatorStorage<Allocator>(alloc), length(0), capacity(InlineCapacity), buffer(this->inlineBuffer()), head(buffer), tail(buffer)
+  {}
+
+  explicit Vector(size_type count, const allocator_type& alloc = allocator_type()):Vector(alloc)
+  {
+    reserve(count);
+
+    for(; length != count; ++length, ++tail)
+      construct(tail);
+  }
+
+  Vector(size_type count, const Type& value, const allocator_type& alloc = allocator_type()):Vector(alloc)
   {
-    tail = head = new Type[S_CAP];
+    reserve(count);
+
+    for(; length != count; ++length, ++tail)
+      construct(tail, value);
   }
 
-  Vector(std::initializer_list<Type> l):Vector()
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  Vector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type()):Vector(alloc)
   {
-    typename std::initializer_list<Type>::iterator it;
+    assign(first, last);
+  }
 
-    for(it = l.begin(); it != l.end(); ++it)
-      append(*it);
+  Vector(std::initializer_list<Type> l, const allocator_type& alloc = allocator_type()):Vector(alloc)
+  {
+    assign(l.begin(), l.end());
     //(void)l; // disables "unused argument" warning, can be removed when method is implemented.
     //throw std::runtime_error("TODO");
   }
 
-  Vector(const Vector& other):Vector()
+  Vector(const Vector& other)
+    :Vector(AllocTraits::select_on_container_copy_construction(other.allocator()))
   {
-    for(const_iterator it = other.cbegin(); it != other.cend(); ++it)
-      append(*it);
+    reserve(other.length);
+
+    tail = uninitializedCopy(static_cast<const Type*>(other.head), static_cast<const Type*>(other.tail), head);
+    length = other.length;
     //(void)other;
     //throw std::runtime_error("TODO");
   }
 
-  Vector(Vector&& other)
+  Vector(Vector&& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible<Type>::value)
+    :AllocatorStorage<Allocator>(other.allocator())
   {
-    length = other.length;
-    capacity = other.capacity;
-
-    head = other.head;
-    tail = other.tail;
-
-    other.length = 0;
-    other.capacity = S_CAP;
-    other.tail = other.head = new Type[S_CAP];
+    steal(other);
     //(void)other;
     //throw std::runtime_error("TODO");
   }
 
   ~Vector()
   {
-    tail = nullptr;
+    release();
+  }
 
-    length = 0;
-    capacity = 0;
+  Vector& operator=(const Vector& other)
+  {
+    if(this == &other)
+      return *this;
 
-    delete[] head;
+    if(AllocTraits::propagate_on_container_copy_assignment::value
+       && allocator() != other.allocator())
+    {
+      // the current buffer must go back to the allocator that provided it
+      release();
+      propagate(other, typename AllocTraits::propagate_on_container_copy_assignment());
+      reset();
+    }
 
-    head = nullptr;
+    assign(static_cast<const Type*>(other.head), static_cast<const Type*>(other.tail));
+
+    return *this;
+    //(void)other;
+    //throw std::runtime_error("TODO");
   }
 
-  Vector& operator=(const Vector& other)
+  Vector& operator=(Vector&& other)
   {
-    erase(cbegin(), cend());
+    if(this == &other)
+      return *this;
 
-    for(const_iterator it = other.cbegin(); it != other.cend(); ++it)
-      append(*it);
+    moveAssign(other, typename AllocTraits::propagate_on_container_move_assignment());
 
     return *this;
     //(void)other;
     //throw std::runtime_error("TODO");
   }
 
-  Vector& operator=(Vector&& other)
+  void swap(Vector& other)
   {
-    Type *del = head;
+    using std::swap;
 
-    length = other.length;
-    capacity = other.capacity;
+    swapAllocators(other, typename AllocTraits::propagate_on_container_swap());
 
-    head = other.head;
-    tail = other.tail;
+    if(isInline() || other.isInline())
+    {
+      Vector temp(std::move(*this));
 
-    other.length = 0;
-    other.capacity = S_CAP;
-    other.tail = other.head = new Type[S_CAP];
+      steal(other);
+      other.steal(temp);
+      return;
+    }
 
-    delete[] del;
+    swap(length, other.length);
+    swap(capacity, other.capacity);
+    swap(buffer, other.buffer);
+    swap(head, other.head);
+    swap(tail, other.tail);
+  }
 
-    return *this;
-    //(void)other;
-    //throw std::runtime_error("TODO");
+  allocator_type getAllocator() const
+  {
+    return allocator();
   }
 
   bool isEmpty() const
@@ -169,113 +944,213 @@ public:
     //throw std::runtime_error("TODO");
   }
 
-  void append(const Type& item)
+  // All zero unless AISDI_LINEAR_STATISTICS is 1.
+  using Statistics::getStatistics;
+
+  // Unused slots of the buffer in use count as slack, and so does the
+  // inline buffer while the elements live on the heap.
+  MemoryUsage memoryUsage() const
   {
-    ++length;
-    Type *temp;
+    MemoryUsage usage;
 
-    //resize needed
-    if((temp = resize()))
-    {
-      Type *del = head;
+    usage.payload = length * sizeof(Type);
+    usage.slack = (capacity - length) * sizeof(Type) + (isInline() ? 0 : InlineCapacity * sizeof(Type));
+    usage.overhead = sizeof(*this) - InlineCapacity * sizeof(Type);
+    return usage;
+  }
+
+  // Destroys the elements, the capacity is kept.
+  void clear()
+  {
+    destroy(head, tail);
+    tail = head = buffer;
+    length = 0;
+  }
 
-      Type  *i;
-      const_iterator it = cbegin();
+  // Slots in the whole buffer, including the slack in front of the contents.
+  size_type getCapacity() const
+  {
+    return capacity;
+  }
 
-      for(i = temp; it != cend(); ++i, ++it)
-        *i = *it;
+  // Makes room for count elements, appending up to that size will not
+  // reallocate.
+  void reserve(size_type count)
+  {
+    if(count > capacity)
+      reallocate(count);
+    else if(count > static_cast<size_type>(storageEnd() - head))
+    {
+      if(Slidable::value)
+        slide(buffer);
+      else
+        reallocate(capacity);
+    }
+  }
 
-      head = temp;
-      tail = i;
+  // Drops the unused capacity, an empty vector gives its buffer back.
+  // Contents that fit go back to the inline buffer.
+  void shrinkToFit()
+  {
+    if(capacity == length || isInline())
+      return;
 
-      delete[] del;
+    if(isEmpty())
+    {
+      release();
+      reset();
     }
-    *(tail++) = item;
+    else
+      reallocate(length);
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
     //(void)item;
     //throw std::runtime_error("TODO");
   }
 
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
   void prepend(const Type& item)
   {
-    Type *temp;
+    emplaceFront(item);
+    //(void)item;
+    //throw std::runtime_error("TODO");
+  }
 
-    //resize needed
-    if((temp = resize()))
-    {
-      Type *del = head;
+  void prepend(Type&& item)
+  {
+    emplaceFront(std::move(item));
+  }
+
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
+    //(void)insertPosition;
+    //(void)item;
+    //throw std::runtime_error("TODO");
+  }
+
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
 
-      *temp = item;
+  // Replaces the contents with [first, last), reallocating at most once
+  // for forward iterators.
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void assign(InputIt first, InputIt last)
+  {
+    assignRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+  }
 
-      Type *i;
-      const_iterator it = cbegin();
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void append(InputIt first, InputIt last)
+  {
+    insert(cend(), first, last);
+  }
 
-      for(i = temp + 1; it != cend(); ++i, ++it)
-        *i = *it;
+  // Inserts [first, last), which must not point into this vector, in front
+  // of insertPosition. Forward ranges are measured first so that the vector
+  // reallocates at most once.
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void insert(const const_iterator& insertPosition, InputIt first, InputIt last)
+  {
+    insertRange(insertPosition.pointee, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+  }
 
-      head = temp;
-      tail = i;
+  template <typename... Args>
+  void emplaceBack(Args&&... args)
+  {
+    if(tail != storageEnd())
+      construct(tail, std::forward<Args>(args)...);
+    else if(canCentre())
+    {
+      // args may refer to elements that are about to move
+      Type value(std::forward<Args>(args)...);
 
-      delete[] del;
+      centre(false);
+      construct(tail, std::move(value));
     }
     else
     {
-      r_move(cbegin());
-
-      *head = item;
+      reallocInsert(tail, false, std::forward<Args>(args)...);
+      --tail;
     }
 
+    ++tail;
     ++length;
-    //(void)item;
-    //throw std::runtime_error("TODO");
   }
 
-  void insert(const const_iterator& insertPosition, const Type& item)
+  template <typename... Args>
+  void emplaceFront(Args&&... args)
   {
-    if(insertPosition == cend())
+    if(head != buffer)
+      construct(head - 1, std::forward<Args>(args)...);
+    else if(canCentre())
     {
-      append(item);
-      return;
-    }
-
-    Type *temp;
+      Type value(std::forward<Args>(args)...);
 
-    //resize needed
-    if((temp = resize()))
+      centre(true);
+      construct(head - 1, std::move(value));
+    }
+    else
     {
-      Type *del = head;
-
-      Type *i;
-      const_iterator it = cbegin();
-
-      //copy from beg to insPos-1
-      for(i = temp; it != insertPosition; ++i, ++it)
-        *i = *it;
+      reallocInsert(head, true, std::forward<Args>(args)...);
+      ++head;
+    }
 
-      //insert element
-      *i = item;
+    --head;
+    ++length;
+  }
 
-      //copy from insPos to end
-      for(++i; it != cend(); ++i, ++it)
-        *i = *it;
+  // Shifts whichever side of insertPosition is shorter and has room.
+  template <typename... Args>
+  void emplace(const const_iterator& insertPosition, Args&&... args)
+  {
+    Type *position = insertPosition.pointee;
 
-      head = temp;
-      tail = i;
+    if(position == tail)
+    {
+      emplaceBack(std::forward<Args>(args)...);
+      return;
+    }
 
-      delete[] del;
+    if(position == head)
+    {
+      emplaceFront(std::forward<Args>(args)...);
+      return;
     }
 
-    //right shift
+    bool frontRoom = head != buffer;
+    bool backRoom = tail != storageEnd();
+
+    //resize needed
+    if(!frontRoom && !backRoom)
+      reallocInsert(position, false, std::forward<Args>(args)...);
     else
     {
-      r_move(insertPosition);
-
-      *( (iterator)insertPosition ) = item;
+      // args may refer to elements inside the shifted range
+      Type value(std::forward<Args>(args)...);
+
+      if(frontRoom && (!backRoom || position - head < tail - position))
+      {
+        openFront(position);
+        fillShifted(position - 1, std::move(value), true, Relocatable());
+      }
+      else
+      {
+        r_move(position);
+        fillShifted(position, std::move(value), false, Relocatable());
+      }
     }
 
     ++length;
-    //(void)insertPosition;
-    //(void)item;
-    //throw std::runtime_error("TODO");
   }
 
   Type popFirst()
@@ -283,11 +1158,12 @@ public:
     if(isEmpty())
       throw std::logic_error("Object cannot be popped.");
 
-    Type obj = *head;
-
-    l_move(cbegin(), cbegin()+1);
+    Type obj = std::move(*head);
 
+    destroy(head, head + 1);
+    ++head;
     --length;
+    rewindIfEmpty();
 
     return obj;
     //throw std::runtime_error("TODO");
@@ -298,9 +1174,14 @@ public:
     if(isEmpty())
       throw std::logic_error("Object cannot be popped.");
 
+    Type obj = std::move(*(tail - 1));
+
+    destroy(tail - 1, tail);
+    --tail;
     --length;
+    rewindIfEmpty();
 
-    return *(--tail);
+    return obj;
     //throw std::runtime_error("TODO");
   }
 
@@ -312,19 +1193,12 @@ public:
     if(position == cend())
       throw std::out_of_range("Erasing at end iterator");
 
-    if(position == cend()-1)
-    {
-      popLast();
-      return;
-    }
-
-    l_move(position, position+1);
-
-    --length;
+    erase(position, position + 1);
     //(void)possition;
     //throw std::runtime_error("TODO");
   }
 
+  // Moves whichever side of the erased range is shorter.
   void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
   {
     if(isEmpty())
@@ -333,14 +1207,102 @@ public:
     if(firstIncluded == lastExcluded)
       return;
 
-    length -= lastExcluded.pointee - firstIncluded.pointee;
+    Type *first = firstIncluded.pointee;
+    Type *last = lastExcluded.pointee;
+
+    length -= last - first;
+
+    if(first - head < tail - last)
+      closeFront(first, last);
+    else
+      l_move(first, last);
 
-    l_move(firstIncluded, lastExcluded);
+    rewindIfEmpty();
     //(void)firstIncluded;
     //(void)lastExcluded;
     //throw std::runtime_error("TODO");
   }
 
+  // Checked like iterators are, see AISDI_CHECKED_ITERATORS.
+  Type& operator[](size_type index)
+  {
+    return const_cast<Type&>(static_cast<const Vector&>(*this)[index]);
+  }
+
+  const Type& operator[](size_type index) const
+  {
+#if AISDI_CHECKED_ITERATORS
+    if(index >= length)
+      throw std::out_of_range("Index out of range.");
+#endif
+
+    return head[index];
+  }
+
+  // Always checked.
+  Type& at(size_type index)
+  {
+    return const_cast<Type&>(static_cast<const Vector&>(*this).at(index));
+  }
+
+  const Type& at(size_type index) const
+  {
+    if(index >= length)
+      throw std::out_of_range("Index out of range.");
+
+    return head[index];
+  }
+
+  // Contiguous storage of getSize() elements, may be null when empty.
+  Type* data()
+  {
+    return head;
+  }
+
+  const Type* data() const
+  {
+    return head;
+  }
+
+  // Writes the elements as one block after a small header, see Snapshot.h.
+  // Throws std::runtime_error on I/O errors, the previous file at path
+  // stays intact then.
+  void saveTo(const std::string& path) const
+  {
+    snapshot::save(path, head, length);
+  }
+
+  // Replaces the contents with a snapshot written by saveTo for the same
+  // element type, read in one block. Throws std::runtime_error when the
+  // file cannot be read, is not such a snapshot or fails its checksum,
+  // leaving the vector empty.
+  void loadFrom(const std::string& path)
+  {
+    static_assert(std::is_trivially_copyable<Type>::value, "Only trivially copyable elements can be loaded");
+
+    snapshot::File file(path, "rb");
+    std::uint64_t fileBytes = file.size();
+    snapshot::Header header;
+    unsigned char headerBytes[snapshot::HEADER_BYTES];
+
+    clear();
+    if(fileBytes < sizeof(headerBytes))
+      throw std::runtime_error("Not a Vector snapshot.");
+    file.read(headerBytes, sizeof(headerBytes));
+    std::memcpy(&header, headerBytes, sizeof(header));
+    snapshot::checkHeader<Type>(header, fileBytes - sizeof(headerBytes));
+
+    size_type count = static_cast<size_type>(header.count);
+
+    reserve(count);
+    file.read(head, count * sizeof(Type));
+    if(snapshot::checksum(head, count * sizeof(Type)) != header.checksum)
+      throw std::runtime_error("Vector snapshot is corrupt.");
+
+    tail = head + count;
+    length = count;
+  }
+
   iterator begin()
   {
     return iterator(head, *this);
@@ -376,11 +1338,11 @@ public:
   }
 };
 
-template <typename Type> //done
-class Vector<Type>::ConstIterator
+template <typename Type, typename Allocator, typename GrowthPolicy, std::size_t InlineCapacity> //done
+class Vector<Type, Allocator, GrowthPolicy, InlineCapacity>::ConstIterator
 {
 public:
-  using iterator_category = std::bidirectional_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
   using value_type = typename Vector::value_type;
   using difference_type = typename Vector::difference_type;
   using pointer = typename Vector::const_pointer;
@@ -388,20 +1350,28 @@ public:
 
 private:
   Type *pointee;
-  const Vector<Type>& vec;
+#if AISDI_CHECKED_ITERATORS
+  const Vector *vec;
+#endif
 
-  friend void aisdi::Vector<Type>::erase(const ConstIterator&, const ConstIterator&);
-  friend void aisdi::Vector<Type>::l_move(const ConstIterator&, const ConstIterator&);
+  friend class Vector;
 
 public:
 
-  explicit ConstIterator(Type *pnt, const Vector<Type>& vtr): pointee(pnt), vec(vtr)
+#if AISDI_CHECKED_ITERATORS
+  explicit ConstIterator(Type *pnt, const Vector& vtr): pointee(pnt), vec(&vtr)
   {}
+#else
+  explicit ConstIterator(Type *pnt, const Vector&): pointee(pnt)
+  {}
+#endif
 
   reference operator*() const
   {
-    if(pointee == vec.tail)
+#if AISDI_CHECKED_ITERATORS
+    if(pointee == vec->tail)
       throw std::out_of_range("Out of range.");
+#endif
 
     return *pointee;
     //throw std::runtime_error("TODO");
@@ -409,8 +1379,10 @@ public:
 
   ConstIterator& operator++()
   {
-    if(pointee == vec.tail)
+#if AISDI_CHECKED_ITERATORS
+    if(pointee == vec->tail)
       throw std::out_of_range("Out of range.");
+#endif
 
     ++pointee;
 
@@ -428,8 +1400,10 @@ public:
 
   ConstIterator& operator--()
   {
-    if(pointee == vec.head)
+#if AISDI_CHECKED_ITERATORS
+    if(pointee == vec->head)
       throw std::out_of_range("Out of range.");
+#endif
 
     --pointee;
 
@@ -445,26 +1419,61 @@ public:
     //throw std::runtime_error("TODO");
   }
 
-  ConstIterator operator+(difference_type d) const
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return *(*this + d);
+  }
+
+  ConstIterator& operator+=(difference_type d)
   {
-    if(pointee + d > vec.tail)
+#if AISDI_CHECKED_ITERATORS
+    if(d > vec->tail - pointee || d < vec->head - pointee)
       throw std::out_of_range("Out of range.");
+#endif
+
+    pointee += d;
+
+    return *this;
+  }
 
-    return ConstIterator(pointee + d, vec);
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    auto result = *this;
+    result += d;
+    return result;
     //(void)d;
     //throw std::runtime_error("TODO");
   }
 
   ConstIterator operator-(difference_type d) const
   {
-    if(pointee - d < vec.head)
-      throw std::out_of_range("Out of range.");
-
-    return ConstIterator(pointee - d, vec);
+    auto result = *this;
+    result -= d;
+    return result;
     //(void)d;
     //throw std::runtime_error("TODO");
   }
 
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return pointee - other.pointee;
+  }
+
   bool operator==(const ConstIterator& other) const
   {
     return this->pointee == other.pointee;
@@ -478,16 +1487,37 @@ public:
     //(void)other;
     //throw std::runtime_error("TODO");
   }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return pointee < other.pointee;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
 };
 
-template <typename Type> //done
-class Vector<Type>::Iterator : public Vector<Type>::ConstIterator
+template <typename Type, typename Allocator, typename GrowthPolicy, std::size_t InlineCapacity> //done
+class Vector<Type, Allocator, GrowthPolicy, InlineCapacity>::Iterator
+  : public Vector<Type, Allocator, GrowthPolicy, InlineCapacity>::ConstIterator
 {
 public:
   using pointer = typename Vector::pointer;
   using reference = typename Vector::reference;
 
-  explicit Iterator(Type *pnt, const Vector<Type>& vtr): ConstIterator(pnt, vtr)
+  explicit Iterator(Type *pnt, const Vector& vtr): ConstIterator(pnt, vtr)
   {}
 
   Iterator(const ConstIterator& other)
@@ -520,23 +1550,57 @@ public:
     return result;
   }
 
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
   Iterator operator+(difference_type d) const
   {
     return ConstIterator::operator+(d);
   }
 
+  using ConstIterator::operator-;
+
   Iterator operator-(difference_type d) const
   {
     return ConstIterator::operator-(d);
   }
 
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
   reference operator*() const
   {
     // ugly cast, yet reduces code duplication.
     return const_cast<reference>(ConstIterator::operator*());
   }
+
+  pointer operator->() const
+  {
+    return &operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return *(*this + d);
+  }
 };
 
+// A Vector keeping up to InlineCapacity elements inside the object, it
+// only allocates once it grows past them.
+template <typename Type, std::size_t InlineCapacity, typename Allocator = std::allocator<Type>>
+using SmallVector = Vector<Type, Allocator, DoublingGrowth, InlineCapacity>;
+
 }
 
 #endif // AISDI_LINEAR_VECTOR_H
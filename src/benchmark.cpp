@@ -0,0 +1,884 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Benchmark.h"
+#include "Vector.h"
+#include "MappedVector.h"
+#include "LinkedList.h"
+#include "IndexedList.h"
+#include "UnrolledList.h"
+#include "CompactList.h"
+#include "ParallelAlgorithms.h"
+#include "ConcurrentQueue.h"
+#include "RingBuffer.h"
+
+namespace
+{
+
+using aisdi::benchmark::keep;
+
+struct Pod16
+{
+  std::int64_t key;
+  std::int64_t payload;
+};
+
+// Values the collections are filled with and the number a scan adds up
+// for each of them.
+inline int makeValue(std::size_t i, int*) { return static_cast<int>(i); }
+inline Pod16 makeValue(std::size_t i, Pod16*) { return Pod16{static_cast<std::int64_t>(i), 0}; }
+
+inline std::size_t weight(int value) { return static_cast<std::size_t>(value); }
+inline std::size_t weight(const Pod16& value) { return static_cast<std::size_t>(value.key); }
+inline std::size_t weight(const std::string& value) { return value.size(); }
+
+// Tags for strings that fit the small string buffer and ones that do not.
+struct ShortString {};
+struct LongString {};
+
+template <typename Element>
+struct ElementTraits
+{
+  using Type = Element;
+  static Type make(std::size_t i) { return makeValue(i, static_cast<Element*>(nullptr)); }
+};
+
+template <>
+struct ElementTraits<ShortString>
+{
+  using Type = std::string;
+  static Type make(std::size_t i) { return std::string(1 + i % 8, 'x'); }
+};
+
+template <>
+struct ElementTraits<LongString>
+{
+  using Type = std::string;
+  static Type make(std::size_t i) { return std::string(64 + i % 8, 'x'); }
+};
+
+// Number of inserts done in the middle, each one at a recomputed position.
+const std::size_t MIDDLE_INSERTS = 16;
+
+template <template <typename> class Collection, typename Element>
+void benchmarkCollection(aisdi::benchmark::Suite& suite, const std::string& container,
+                         const std::string& element, std::size_t size)
+{
+  using Type = typename ElementTraits<Element>::Type;
+  using Filled = Collection<Type>;
+
+  aisdi::Vector<Type> values;
+  values.reserve(size);
+  for (std::size_t i = 0; i < size; ++i)
+    values.append(ElementTraits<Element>::make(i));
+
+  auto empty = []() { return Filled(); };
+  auto filled = [&]()
+  {
+    Filled collection;
+    for (const Type& value : values)
+      collection.append(value);
+    return collection;
+  };
+  auto run = [&](const std::string& operation, std::size_t work, auto setup, auto body)
+  {
+    suite.run(container, element, operation, size, work, setup, body);
+  };
+
+  run("append", size, empty, [&](Filled& collection)
+  {
+    for (const Type& value : values)
+      collection.append(value);
+  });
+
+  run("prepend", size, empty, [&](Filled& collection)
+  {
+    for (const Type& value : values)
+      collection.prepend(value);
+  });
+
+  run("insertMiddle", MIDDLE_INSERTS, filled, [&](Filled& collection)
+  {
+    for (std::size_t i = 0; i < MIDDLE_INSERTS; ++i)
+      collection.insert(collection.begin() + collection.getSize() / 2, values[i % size]);
+  });
+
+  run("iterate", size, filled, [&](Filled& collection)
+  {
+    std::size_t sum = 0;
+    for (const Type& value : collection)
+      sum += weight(value);
+    keep(sum);
+  });
+
+  auto pair = [&]() { return std::make_pair(filled(), Filled()); };
+
+  run("copy", size, pair, [&](std::pair<Filled, Filled>& collections)
+  {
+    collections.second = collections.first;
+  });
+
+  run("move", 1, pair, [&](std::pair<Filled, Filled>& collections)
+  {
+    collections.second = std::move(collections.first);
+  });
+
+  run("popFirst", size, filled, [&](Filled& collection)
+  {
+    while (!collection.isEmpty())
+      keep(collection.popFirst());
+  });
+
+  run("popLast", size, filled, [&](Filled& collection)
+  {
+    while (!collection.isEmpty())
+      keep(collection.popLast());
+  });
+
+  run("eraseRange", size / 2, filled, [&](Filled& collection)
+  {
+    collection.erase(collection.begin() + size / 4, collection.begin() + size / 4 + size / 2);
+  });
+}
+
+template <typename T>
+using Vector = aisdi::Vector<T>;
+template <typename T>
+using LinkedList = aisdi::LinkedList<T>;
+template <typename T>
+using IndexedList = aisdi::IndexedList<T>;
+template <typename T>
+using UnrolledList = aisdi::UnrolledList<T>;
+template <typename T>
+using CompactList = aisdi::CompactList<T>;
+
+// Element counts whose payload fills about 16KB, 256KB, 4MB and 64MB,
+// from inside L1 out to main memory.
+template <typename Element>
+void benchmarkElement(aisdi::benchmark::Suite& suite, const std::string& element, std::size_t maxBytes)
+{
+  using Type = typename ElementTraits<Element>::Type;
+
+  for (std::size_t bytes = 16 << 10; bytes <= maxBytes; bytes *= 16)
+  {
+    std::size_t size = bytes / sizeof(Type);
+
+    benchmarkCollection<Vector, Element>(suite, "Vector", element, size);
+    benchmarkCollection<LinkedList, Element>(suite, "LinkedList", element, size);
+    benchmarkCollection<IndexedList, Element>(suite, "IndexedList", element, size);
+    benchmarkCollection<UnrolledList, Element>(suite, "UnrolledList", element, size);
+    benchmarkCollection<CompactList, Element>(suite, "CompactList", element, size);
+  }
+}
+
+// The comparison mode runs the same workload scripts through the aisdi
+// containers and their std counterparts, through Ops adapters.
+
+struct AisdiOps
+{
+  template <typename Collection, typename Type>
+  static void pushBack(Collection& collection, const Type& value) { collection.append(value); }
+
+  template <typename Collection, typename Type>
+  static void pushFront(Collection& collection, const Type& value) { collection.prepend(value); }
+
+  template <typename Collection>
+  static void popFront(Collection& collection) { keep(collection.popFirst()); }
+
+  template <typename Collection>
+  static void popBack(Collection& collection) { keep(collection.popLast()); }
+
+  template <typename Collection, typename Type>
+  static void insertAt(Collection& collection, std::size_t index, const Type& value)
+  {
+    collection.insert(collection.begin() + index, value);
+  }
+
+  template <typename Collection>
+  static void eraseRange(Collection& collection, std::size_t first, std::size_t last)
+  {
+    collection.erase(collection.begin() + first, collection.begin() + last);
+  }
+
+  template <typename Collection>
+  static std::size_t size(const Collection& collection) { return collection.getSize(); }
+};
+
+// Front operations go through insert and erase, so std::vector takes its
+// linear path just as aisdi::Vector did before it kept front slack.
+struct StdOps
+{
+  template <typename Collection, typename Type>
+  static void pushBack(Collection& collection, const Type& value) { collection.push_back(value); }
+
+  template <typename Collection, typename Type>
+  static void pushFront(Collection& collection, const Type& value) { collection.insert(collection.begin(), value); }
+
+  template <typename Collection>
+  static void popFront(Collection& collection) { collection.erase(collection.begin()); }
+
+  template <typename Collection>
+  static void popBack(Collection& collection) { collection.pop_back(); }
+
+  template <typename Collection, typename Type>
+  static void insertAt(Collection& collection, std::size_t index, const Type& value)
+  {
+    collection.insert(std::next(collection.begin(), index), value);
+  }
+
+  template <typename Collection>
+  static void eraseRange(Collection& collection, std::size_t first, std::size_t last)
+  {
+    collection.erase(std::next(collection.begin(), first), std::next(collection.begin(), last));
+  }
+
+  template <typename Collection>
+  static std::size_t size(const Collection& collection) { return collection.size(); }
+};
+
+template <typename T>
+using Counted = aisdi::benchmark::CountingAllocator<T>;
+
+// Largest size at which containers with linear front operations still
+// run the workload made of them, past it they would take hours.
+const std::size_t LINEAR_FRONT_LIMIT = 1 << 16;
+
+template <typename Ops, typename Collection, typename Type>
+void compareCollection(aisdi::benchmark::Suite& suite, const std::string& container, const std::string& element,
+                       const aisdi::Vector<Type>& values, bool linearFront = false)
+{
+  std::size_t size = values.getSize();
+  auto run = [&](const std::string& workload, std::size_t work, auto script)
+  {
+    aisdi::benchmark::AllocationCounter::resetPeak();
+    aisdi::benchmark::Result& result = suite.run(container, element, workload, size, work,
+                                                 []() { return Collection(); }, script);
+    result.peakBytes = aisdi::benchmark::AllocationCounter::getPeak() - aisdi::benchmark::AllocationCounter::getCurrent();
+  };
+
+  // what performTest1 and performTest2 time
+  if (!linearFront || size <= LINEAR_FRONT_LIMIT)
+    run("appendPrependErase", 4 * size, [&](Collection& collection)
+    {
+      for (const Type& value : values)
+        Ops::pushBack(collection, value);
+      for (const Type& value : values)
+        Ops::pushFront(collection, value);
+      for (std::size_t i = 0; i < size; ++i)
+        Ops::popFront(collection);
+      for (std::size_t i = 0; i < size; ++i)
+        Ops::popBack(collection);
+    });
+
+  run("queue", 2 * size, [&](Collection& collection)
+  {
+    for (std::size_t i = 0; i < 16 && i < size; ++i)
+      Ops::pushBack(collection, values[i]);
+    for (const Type& value : values)
+    {
+      Ops::pushBack(collection, value);
+      Ops::popFront(collection);
+    }
+  });
+
+  run("buildAndScan", 11 * size, [&](Collection& collection)
+  {
+    std::size_t sum = 0;
+
+    for (const Type& value : values)
+      Ops::pushBack(collection, value);
+    for (std::size_t pass = 0; pass < 10; ++pass)
+      for (const Type& value : collection)
+        sum += weight(value);
+    keep(sum);
+  });
+
+  run("middleInsertErase", size + MIDDLE_INSERTS + size / 2, [&](Collection& collection)
+  {
+    for (const Type& value : values)
+      Ops::pushBack(collection, value);
+    for (std::size_t i = 0; i < MIDDLE_INSERTS; ++i)
+      Ops::insertAt(collection, Ops::size(collection) / 2, values[i % size]);
+    Ops::eraseRange(collection, size / 4, size / 4 + size / 2);
+  });
+}
+
+template <typename Element>
+void compareElement(aisdi::benchmark::Suite& suite, const std::string& element, std::size_t maxBytes)
+{
+  using Type = typename ElementTraits<Element>::Type;
+
+  for (std::size_t bytes = 16 << 10; bytes <= maxBytes; bytes *= 16)
+  {
+    aisdi::Vector<Type> values;
+    for (std::size_t i = 0, size = bytes / sizeof(Type); i < size; ++i)
+      values.append(ElementTraits<Element>::make(i));
+
+    compareCollection<AisdiOps, aisdi::Vector<Type, Counted<Type>>>(suite, "aisdi::Vector", element, values);
+    compareCollection<StdOps, std::vector<Type, Counted<Type>>>(suite, "std::vector", element, values, true);
+    compareCollection<StdOps, std::deque<Type, Counted<Type>>>(suite, "std::deque", element, values);
+    compareCollection<AisdiOps, aisdi::LinkedList<Type, Counted<Type>>>(suite, "aisdi::LinkedList", element, values);
+    compareCollection<StdOps, std::list<Type, Counted<Type>>>(suite, "std::list", element, values);
+    compareCollection<AisdiOps, aisdi::CompactList<Type, Counted<Type>>>(suite, "aisdi::CompactList", element, values);
+  }
+}
+
+// The scenarios time whole workloads the sweeps above leave out: queues,
+// seeks, small vectors, footprints, snapshots, the parallel algorithms and
+// the concurrent queues. count scales all of them, as the element count of
+// the original timers did.
+
+using aisdi::benchmark::Clock;
+using aisdi::benchmark::Suite;
+
+std::string threadLabel(std::size_t producers, std::size_t consumers)
+{
+  return "(" + std::to_string(producers) + "+" + std::to_string(consumers) + ")";
+}
+
+template <typename Collection>
+Collection filledWith(std::size_t count)
+{
+  Collection collection;
+  for (std::size_t i = 0; i < count; ++i)
+    collection.append("DONE");
+  return collection;
+}
+
+template <typename Collection>
+void scenarioQueue(Suite& suite, const std::string& container, std::size_t n)
+{
+  auto primed = []() { return filledWith<Collection>(16); };
+
+  suite.run(container, "shortString", "queue", 16, 2 * n, primed, [n](Collection& collection)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      collection.append("DONE");
+      collection.popFirst();
+    }
+  });
+
+  suite.run(container, "shortString", "reverseQueue", 16, 2 * n, primed, [n](Collection& collection)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      collection.prepend("DONE");
+      collection.popLast();
+    }
+  });
+}
+
+const std::size_t SEEKS = 1000;
+
+template <typename Collection>
+void scenarioSeek(Suite& suite, const std::string& container, std::size_t n)
+{
+  suite.run(container, "shortString", "seek", n, SEEKS, [n]() { return filledWith<Collection>(n); },
+            [n](Collection& collection)
+  {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < SEEKS; ++i)
+      sum += (*(collection.begin() + (i * 7919) % n)).size();
+    keep(sum);
+  });
+}
+
+// Inserts in the middle through a recomputed iterator, then scans.
+template <typename Collection>
+void scenarioScan(Suite& suite, const std::string& container, std::size_t n)
+{
+  auto filled = [n]() { return filledWith<Collection>(n); };
+
+  suite.run(container, "shortString", "middleInsert", n, n / 10, filled, [n](Collection& collection)
+  {
+    for (std::size_t i = 0; i < n / 10; ++i)
+      collection.insert(collection.begin() + n / 2, "MIDDLE");
+  });
+
+  suite.run(container, "shortString", "scan", n, 10 * n, filled, [](Collection& collection)
+  {
+    std::size_t sum = 0;
+    for (std::size_t pass = 0; pass < 10; ++pass)
+      for (auto it = collection.begin(); it != collection.end(); ++it)
+        sum += (*it).size();
+    keep(sum);
+  });
+}
+
+// Many short-lived collections of four elements, each copied once.
+template <typename Collection>
+void scenarioSmall(Suite& suite, const std::string& container, std::size_t n)
+{
+  suite.run(container, "shortString", "smallBuild", 4, n, []() { return std::size_t(0); },
+            [n](std::size_t& sum)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      Collection collection = filledWith<Collection>(4);
+      Collection copy(collection);
+      sum += copy.getSize();
+    }
+  });
+}
+
+// Times filling the collection with n ints; peakBytes is what
+// memoryUsage() reports afterwards, the container object included.
+template <typename Collection>
+void scenarioFootprint(Suite& suite, const std::string& container, std::size_t n)
+{
+  auto fill = [n](Collection& collection)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      collection.append(static_cast<int>(i));
+  };
+
+  aisdi::benchmark::Result& result = suite.run(container, "int", "footprint", n, n,
+                                               []() { return Collection(); }, fill);
+  Collection collection;
+  fill(collection);
+  result.peakBytes = collection.memoryUsage().total();
+}
+
+// Path in TMPDIR, or /tmp, unique to this process. The file is removed
+// when the object goes out of scope, also when a benchmark throws.
+class TemporaryFile
+{
+  std::string path;
+
+public:
+
+  explicit TemporaryFile(const std::string& name)
+  {
+    const char *directory = std::getenv("TMPDIR");
+
+    path = std::string(directory != nullptr && *directory != '\0' ? directory : "/tmp")
+      + "/" + name + "." + std::to_string(::getpid());
+  }
+
+  TemporaryFile(const TemporaryFile&) = delete;
+  TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+  ~TemporaryFile()
+  {
+    std::remove(path.c_str());
+  }
+
+  const std::string& getPath() const
+  {
+    return path;
+  }
+};
+
+// Restoring n elements by appending them one by one, from a saveTo
+// snapshot with loadFrom, and through a MappedVector of the same file.
+void scenarioSnapshot(Suite& suite, std::size_t n)
+{
+  TemporaryFile file("aisdiBenchmark.snapshot");
+  const std::string& path = file.getPath();
+  aisdi::Vector<long> source;
+
+  source.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    source.append(static_cast<long>(i));
+
+  auto empty = []() { return aisdi::Vector<long>(); };
+
+  suite.run("Vector", "long", "rebuild", n, n, empty, [n](aisdi::Vector<long>& collection)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      collection.append(static_cast<long>(i));
+  });
+
+  suite.run("Vector", "long", "save", n, n, []() { return 0; }, [&](int&)
+  {
+    source.saveTo(path);
+  });
+
+  suite.run("Vector", "long", "load", n, n, empty, [&](aisdi::Vector<long>& collection)
+  {
+    collection.loadFrom(path);
+  });
+
+  suite.run("MappedVector", "long", "mapAndScan", n, n, []() { return 0L; }, [&](long& sum)
+  {
+    aisdi::MappedVector<long> mapped(path);
+    for (long value : mapped)
+      sum += value;
+  });
+}
+
+std::string poolName(std::size_t threads)
+{
+  return "ThreadPool(" + std::to_string(threads) + ")";
+}
+
+// Runs the parallel algorithms over n elements with 1, 2, 4, ... threads
+// up to the number of cores, each pool named by its thread count.
+void scenarioParallel(Suite& suite, std::size_t n)
+{
+  aisdi::Vector<long> source;
+
+  source.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    source.append(static_cast<long>((i * 2654435761u) % 1000003));
+
+  auto copy = [&]() { return aisdi::Vector<long>(source); };
+
+  for (std::size_t threads = 1; ; threads *= 2)
+  {
+    if (threads > aisdi::ThreadPool::defaultThreadCount())
+      threads = aisdi::ThreadPool::defaultThreadCount();
+
+    aisdi::ThreadPool pool(threads);
+    const std::string container = poolName(threads);
+
+    suite.run(container, "long", "forEach", n, n, copy, [&](aisdi::Vector<long>& work)
+    {
+      aisdi::forEach(pool, work, [](long& value) { value = value * 3 + 1; });
+    });
+
+    suite.run(container, "long", "transform", n, n, [n]() { return aisdi::Vector<long>(n); },
+              [&](aisdi::Vector<long>& doubled)
+    {
+      aisdi::transform(pool, source, doubled, [](long value) { return value * 2; });
+    });
+
+    suite.run(container, "long", "reduce", n, n, []() { return 0L; }, [&](long& sum)
+    {
+      sum = aisdi::reduce(pool, source, 0L, [](long a, long b) { return a + b; });
+    });
+
+    suite.run(container, "long", "countIf", n, n, []() { return std::size_t(0); }, [&](std::size_t& odd)
+    {
+      odd = aisdi::countIf(pool, source, [](long value) { return value % 2 != 0; });
+    });
+
+    suite.run(container, "long", "sort", n, n, copy, [&](aisdi::Vector<long>& work)
+    {
+      aisdi::sort(pool, work);
+    });
+
+    if (threads == aisdi::ThreadPool::defaultThreadCount())
+      break;
+  }
+}
+
+// LinkedList behind a mutex, the baseline for the lock-free queue.
+template <typename T>
+class LockedQueue
+{
+  std::mutex mutex;
+  aisdi::LinkedList<T> list;
+
+public:
+  void push(const T& item)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    list.append(item);
+  }
+
+  bool tryPop(T& item)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (list.isEmpty())
+      return false;
+    item = list.popFirst();
+    return true;
+  }
+};
+
+// Half the threads push n timestamps in total, the other half pop them.
+// Besides the handoff as a whole, records the time every element of the
+// last run spent in the queue as handoffLatency. The queue is built in the
+// timed body, new cannot give it its cache line alignment before C++17.
+template <typename Queue>
+void scenarioConcurrentQueue(Suite& suite, const std::string& container, std::size_t n)
+{
+  std::size_t producers = std::max<std::size_t>(1, aisdi::ThreadPool::defaultThreadCount() / 2);
+  std::size_t consumers = producers;
+  const std::string threads = threadLabel(producers, consumers);
+  const double nanosPerTick = 1e9 * Clock::period::num / Clock::period::den;
+  aisdi::Vector<double> latencies;
+  std::mutex latencyMutex;
+
+  suite.run(container, "timestamp", "handoff" + threads, n, n,
+            []() { return 0; }, [&](int&)
+  {
+    Queue queue;
+    std::atomic<std::size_t> popped(0);
+    std::vector<std::thread> workers;
+
+    latencies.clear();
+    for (std::size_t p = 0; p < producers; ++p)
+      workers.emplace_back([&, p]()
+      {
+        for (std::size_t i = p; i < n; i += producers)
+          queue.push(Clock::now().time_since_epoch().count());
+      });
+
+    for (std::size_t c = 0; c < consumers; ++c)
+      workers.emplace_back([&]()
+      {
+        aisdi::Vector<double> seen;
+        Clock::rep stamp;
+
+        while (popped.load() < n)
+        {
+          if (!queue.tryPop(stamp))
+          {
+            std::this_thread::yield();
+            continue;
+          }
+
+          seen.append((Clock::now().time_since_epoch().count() - stamp) * nanosPerTick);
+          ++popped;
+        }
+
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        for (double latency : seen)
+          latencies.append(latency);
+      });
+
+    for (auto& worker : workers)
+      worker.join();
+  });
+
+  suite.record(container, "timestamp", "handoffLatency" + threads, n, 1, std::move(latencies));
+}
+
+// Hands n integers from producers to consumers through a ring of 1024
+// slots, one at a time or in batches of up to batch elements. Built in the
+// timed body like the queues above.
+template <typename Ring>
+void scenarioRing(Suite& suite, const std::string& container, std::size_t n, std::size_t threadsPerSide,
+                  std::size_t batch)
+{
+  const std::string operation = "handoff" + threadLabel(threadsPerSide, threadsPerSide)
+    + "batch" + std::to_string(batch);
+
+  suite.run(container, "size_t", operation, n, n,
+            []() { return 0; }, [&](int&)
+  {
+    Ring ring(1024);
+    std::atomic<std::size_t> popped(0);
+    std::atomic<std::size_t> checksum(0);
+    std::vector<std::thread> workers;
+
+    for (std::size_t p = 0; p < threadsPerSide; ++p)
+      workers.emplace_back([&, p]()
+      {
+        std::vector<std::size_t> items(batch);
+        std::size_t i = p;
+
+        while (i < n)
+        {
+          std::size_t count = 0;
+          for (; count < batch && i + count * threadsPerSide < n; ++count)
+            items[count] = i + count * threadsPerSide;
+
+          std::size_t pushed = batch == 1 ? ring.tryPush(items[0]) : ring.pushMany(items.begin(), items.begin() + count);
+          if (pushed == 0)
+            std::this_thread::yield();
+          i += pushed * threadsPerSide;
+        }
+      });
+
+    for (std::size_t c = 0; c < threadsPerSide; ++c)
+      workers.emplace_back([&]()
+      {
+        std::vector<std::size_t> items(batch);
+        std::size_t sum = 0;
+
+        while (popped.load() < n)
+        {
+          std::size_t count = batch == 1 ? ring.tryPop(items[0]) : ring.popMany(items.begin(), batch);
+          if (count == 0)
+          {
+            std::this_thread::yield();
+            continue;
+          }
+
+          for (std::size_t k = 0; k < count; ++k)
+            sum += items[k];
+          popped += count;
+        }
+
+        checksum += sum;
+      });
+
+    for (auto& worker : workers)
+      worker.join();
+    keep(checksum.load());
+  });
+}
+
+template <typename T>
+using SmallVector = aisdi::SmallVector<T, 8>;
+
+void runScenarios(Suite& suite, std::size_t count)
+{
+  using Stamp = Clock::rep;
+  std::size_t threadsPerSide = std::max<std::size_t>(1, aisdi::ThreadPool::defaultThreadCount() / 2);
+
+  scenarioQueue<LinkedList<std::string>>(suite, "LinkedList", count);
+  scenarioQueue<Vector<std::string>>(suite, "Vector", count);
+
+  scenarioSeek<LinkedList<std::string>>(suite, "LinkedList", count);
+  scenarioSeek<IndexedList<std::string>>(suite, "IndexedList", count);
+
+  scenarioScan<LinkedList<std::string>>(suite, "LinkedList", count);
+  scenarioScan<Vector<std::string>>(suite, "Vector", count);
+  scenarioScan<UnrolledList<std::string>>(suite, "UnrolledList", count);
+  scenarioScan<CompactList<std::string>>(suite, "CompactList", count);
+
+  scenarioSmall<Vector<std::string>>(suite, "Vector", count);
+  scenarioSmall<SmallVector<std::string>>(suite, "SmallVector", count);
+
+  scenarioFootprint<Vector<int>>(suite, "Vector", count * 10);
+  scenarioFootprint<LinkedList<int>>(suite, "LinkedList", count * 10);
+  scenarioFootprint<CompactList<int>>(suite, "CompactList", count * 10);
+  scenarioFootprint<IndexedList<int>>(suite, "IndexedList", count * 10);
+  scenarioFootprint<UnrolledList<int>>(suite, "UnrolledList", count * 10);
+
+  scenarioSnapshot(suite, count * 100);
+  scenarioParallel(suite, count * 100);
+
+  scenarioConcurrentQueue<LockedQueue<Stamp>>(suite, "LockedQueue", count * 10);
+  scenarioConcurrentQueue<aisdi::ConcurrentQueue<Stamp>>(suite, "ConcurrentQueue", count * 10);
+
+  scenarioRing<aisdi::SpscRingBuffer<std::size_t>>(suite, "SpscRingBuffer", count * 100, 1, 1);
+  scenarioRing<aisdi::SpscRingBuffer<std::size_t>>(suite, "SpscRingBuffer", count * 100, 1, 64);
+  scenarioRing<aisdi::MpmcRingBuffer<std::size_t>>(suite, "MpmcRingBuffer", count * 100, threadsPerSide, 1);
+  scenarioRing<aisdi::MpmcRingBuffer<std::size_t>>(suite, "MpmcRingBuffer", count * 100, threadsPerSide, 64);
+
+  suite.relateTo("IndexedList", "LinkedList");
+  suite.relateTo("SmallVector", "Vector");
+  suite.relateTo("ConcurrentQueue", "LockedQueue");
+  for (std::size_t threads = 1; ; threads *= 2)
+  {
+    if (threads > aisdi::ThreadPool::defaultThreadCount())
+      threads = aisdi::ThreadPool::defaultThreadCount();
+    suite.relateTo(poolName(threads), poolName(1));
+    if (threads == aisdi::ThreadPool::defaultThreadCount())
+      break;
+  }
+}
+
+bool readOption(const char *argument, const char *name, std::string& value)
+{
+  std::size_t length = std::strlen(name);
+
+  if (std::strncmp(argument, name, length) != 0 || argument[length] != '=')
+    return false;
+
+  value = argument + length + 1;
+  return true;
+}
+
+} // namespace
+
+// usage: aisdiBenchmark [--compare | --scenarios] [--format=csv|json] [--warmup=N] [--repetitions=N]
+//                       [--max-bytes=N] [--count=N]
+// --compare runs the workloads against the std containers instead, with
+// relative throughput and peak container memory. --scenarios runs the
+// scenarios above, scaled by --count.
+int main(int argc, char** argv)
+{
+  aisdi::benchmark::Config config;
+  std::string format = "csv";
+  std::size_t maxBytes = 64 << 20;
+  std::size_t count = 10000;
+  bool compare = false;
+  bool scenarios = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string value;
+
+    if (std::strcmp(argv[i], "--compare") == 0)
+      compare = true;
+    else if (std::strcmp(argv[i], "--scenarios") == 0)
+      scenarios = true;
+    else if (readOption(argv[i], "--format", value))
+      format = value;
+    else if (readOption(argv[i], "--warmup", value))
+      config.warmup = std::strtoull(value.c_str(), nullptr, 10);
+    else if (readOption(argv[i], "--repetitions", value))
+      config.repetitions = std::strtoull(value.c_str(), nullptr, 10);
+    else if (readOption(argv[i], "--max-bytes", value))
+      maxBytes = std::strtoull(value.c_str(), nullptr, 10);
+    else if (readOption(argv[i], "--count", value))
+      count = std::strtoull(value.c_str(), nullptr, 10);
+    else
+    {
+      std::cerr << "Unknown option: " << argv[i] << "\n";
+      return 1;
+    }
+  }
+
+  if (format != "csv" && format != "json")
+  {
+    std::cerr << "Unknown format: " << format << "\n";
+    return 1;
+  }
+
+  if (compare && scenarios)
+  {
+    std::cerr << "--compare and --scenarios cannot be combined\n";
+    return 1;
+  }
+
+  aisdi::benchmark::Suite suite(config);
+
+  if (compare)
+  {
+    compareElement<int>(suite, "int", maxBytes);
+    compareElement<Pod16>(suite, "pod16", maxBytes);
+    compareElement<ShortString>(suite, "shortString", maxBytes);
+    compareElement<LongString>(suite, "longString", maxBytes);
+
+    suite.relateTo("std::vector", "std::vector");
+    suite.relateTo("aisdi::Vector", "std::vector");
+    suite.relateTo("std::deque", "std::vector");
+    suite.relateTo("std::list", "std::list");
+    suite.relateTo("aisdi::LinkedList", "std::list");
+    suite.relateTo("aisdi::CompactList", "std::list");
+  }
+  else if (scenarios)
+    runScenarios(suite, count);
+  else
+  {
+    benchmarkElement<int>(suite, "int", maxBytes);
+    benchmarkElement<Pod16>(suite, "pod16", maxBytes);
+    benchmarkElement<ShortString>(suite, "shortString", maxBytes);
+    benchmarkElement<LongString>(suite, "longString", maxBytes);
+  }
+
+  if (format == "json")
+    suite.writeJson(std::cout);
+  else
+    suite.writeCsv(std::cout);
+
+#if AISDI_LINEAR_STATISTICS
+  std::cerr << "Container statistics\n";
+  aisdi::GlobalStatistics::dump(std::cerr);
+#endif
+  return 0;
+}
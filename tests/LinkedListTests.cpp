@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include "LinkedList.h"
+
+namespace
+{
+
+using List = aisdi::LinkedList<int>;
+
+std::vector<int> contents(const List& list)
+{
+  std::vector<int> values;
+
+  for (auto it = list.begin(); it != list.end() && values.size() <= list.getSize(); ++it)
+    values.push_back(*it);
+  return values;
+}
+
+}
+
+// A self-splice that corrupts the links loops forever, the timeouts turn
+// that into a failure.
+BOOST_AUTO_TEST_SUITE(LinkedListTests)
+
+BOOST_AUTO_TEST_CASE(GivenElementSplicedInFrontOfItself_ThenListIsUnchanged, * boost::unit_test::timeout(5))
+{
+  List list = {1, 2, 3};
+
+  list.splice(list.begin() + 1, list, list.begin() + 1);
+
+  BOOST_CHECK(contents(list) == (std::vector<int>{1, 2, 3}));
+  BOOST_CHECK_EQUAL(*(list.end() - 1), 3);
+  BOOST_CHECK_EQUAL(*((list.end() - 1) - 2), 1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenElementSplicedInFrontOfItsSuccessor_ThenListIsUnchanged)
+{
+  List list = {1, 2, 3};
+
+  list.splice(list.begin() + 2, list, list.begin() + 1);
+
+  BOOST_CHECK(contents(list) == (std::vector<int>{1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(GivenRangeSplicedInFrontOfItsFirstElement_ThenListIsUnchanged, * boost::unit_test::timeout(5))
+{
+  List list = {1, 2, 3, 4};
+
+  list.splice(list.begin() + 1, list, list.begin() + 1, list.begin() + 3);
+
+  BOOST_CHECK(contents(list) == (std::vector<int>{1, 2, 3, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(GivenElementSplicedWithinList_ThenNodeIsRelinked)
+{
+  List list = {1, 2, 3};
+  const int *third = &*(list.begin() + 2);
+
+  list.splice(list.begin(), list, list.begin() + 2);
+
+  BOOST_CHECK(contents(list) == (std::vector<int>{3, 1, 2}));
+  BOOST_CHECK_EQUAL(&*list.begin(), third);
+}
+
+BOOST_AUTO_TEST_CASE(GivenOtherList_WhenSplicingOneElement_ThenThrows)
+{
+  List list = {1, 2};
+  List other = {3};
+
+  BOOST_CHECK_THROW(list.splice(list.begin(), other, other.begin()), std::invalid_argument);
+  BOOST_CHECK(contents(other) == (std::vector<int>{3}));
+}
+
+BOOST_AUTO_TEST_CASE(GivenListsWithSpareNodes_WhenSplicedRepeatedly_ThenPoolsStayConsistent)
+{
+  List list;
+  std::vector<int> expected;
+
+  for (int round = 0; round < 20; ++round)
+  {
+    List other;
+    for (int i = 0; i < 50; ++i)
+      other.append(round * 100 + i);
+    other.erase(other.begin() + 10, other.begin() + 30);
+    if (!list.isEmpty())
+      list.erase(list.begin());
+    if (!expected.empty())
+      expected.erase(expected.begin());
+
+    for (int i = 0; i < 50; ++i)
+      if (i < 10 || i >= 30)
+        expected.push_back(round * 100 + i);
+    list.splice(list.end(), other);
+
+    BOOST_REQUIRE(other.isEmpty());
+    BOOST_CHECK_EQUAL(other.memoryUsage().slack, 0u);
+  }
+
+  for (int i = 0; i < 500; ++i)
+  {
+    list.append(-i);
+    expected.push_back(-i);
+  }
+  BOOST_CHECK(contents(list) == expected);
+
+  list.clear();
+  list.shrinkToFit();
+  BOOST_CHECK_EQUAL(list.memoryUsage().total(), sizeof(List));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,70 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "ParallelAlgorithms.h"
+
+namespace
+{
+
+using Keyed = std::pair<std::string, std::size_t>;
+
+bool byKey(const Keyed& a, const Keyed& b)
+{
+  return a.first < b.first;
+}
+
+// Few distinct keys, so stability matters, and strings, so reading a
+// moved-from element shows up as a lost key.
+aisdi::Vector<Keyed> makeKeyed(std::size_t count)
+{
+  aisdi::Vector<Keyed> collection;
+
+  for (std::size_t i = 0; i < count; ++i)
+    collection.append(Keyed("key" + std::to_string((i * 2654435761u) % 97), i));
+  return collection;
+}
+
+void checkSortMatchesStableSort(std::size_t count)
+{
+  aisdi::ThreadPool pool(4);
+  aisdi::ParallelConfig config;
+  config.grain = 64;
+  config.sequentialThreshold = 128;
+
+  aisdi::Vector<Keyed> sorted = makeKeyed(count);
+  aisdi::Vector<Keyed> expected = makeKeyed(count);
+
+  aisdi::sort(pool, sorted, byKey, config);
+  std::stable_sort(expected.begin(), expected.end(), byKey);
+
+  BOOST_REQUIRE_EQUAL(sorted.getSize(), expected.getSize());
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sorted[i].first, expected[i].first);
+    BOOST_REQUIRE_EQUAL(sorted[i].second, expected[i].second);
+  }
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(ParallelAlgorithmsTests)
+
+BOOST_AUTO_TEST_CASE(GivenStrings_WhenSortingInParallel_ThenResultMatchesStableSort)
+{
+  checkSortMatchesStableSort(5000);
+}
+
+BOOST_AUTO_TEST_CASE(GivenOddRunCount_WhenSortingInParallel_ThenResultMatchesStableSort)
+{
+  checkSortMatchesStableSort(64 * 13 + 5);
+}
+
+BOOST_AUTO_TEST_CASE(GivenRangeBelowThreshold_WhenSorting_ThenResultMatchesStableSort)
+{
+  checkSortMatchesStableSort(100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
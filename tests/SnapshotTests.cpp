@@ -0,0 +1,90 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include "MappedVector.h"
+#include "Vector.h"
+
+namespace
+{
+
+// Snapshot of {1, 2, 3} in a per-process temporary file, removed when the
+// test ends however it ends.
+struct SnapshotFile
+{
+  std::string path;
+
+  SnapshotFile()
+  {
+    const char *directory = std::getenv("TMPDIR");
+    path = std::string(directory != nullptr ? directory : "/tmp")
+      + "/aisdiSnapshotTests." + std::to_string(::getpid());
+
+    aisdi::Vector<int> collection = {1, 2, 3};
+    collection.saveTo(path);
+  }
+
+  ~SnapshotFile()
+  {
+    std::remove(path.c_str());
+  }
+
+  void resize(long bytes)
+  {
+    BOOST_REQUIRE_EQUAL(::truncate(path.c_str(), bytes), 0);
+  }
+};
+
+const long SNAPSHOT_BYTES = static_cast<long>(aisdi::snapshot::HEADER_BYTES + 3 * sizeof(int));
+
+void checkRejected(const std::string& path)
+{
+  aisdi::Vector<int> collection = {7};
+
+  BOOST_CHECK_THROW(collection.loadFrom(path), std::runtime_error);
+  BOOST_CHECK(collection.isEmpty());
+  BOOST_CHECK_THROW(aisdi::MappedVector<int> mapped(path), std::runtime_error);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(SnapshotTests)
+
+BOOST_AUTO_TEST_CASE(GivenExactSnapshot_WhenLoading_ThenElementsMatch)
+{
+  SnapshotFile file;
+  aisdi::Vector<int> collection;
+
+  collection.loadFrom(file.path);
+  aisdi::MappedVector<int> mapped(file.path);
+
+  BOOST_CHECK_EQUAL(collection.getSize(), 3u);
+  BOOST_CHECK_EQUAL(collection[2], 3);
+  BOOST_CHECK_EQUAL(mapped.getSize(), 3u);
+  BOOST_CHECK(mapped.verify());
+}
+
+BOOST_AUTO_TEST_CASE(GivenTruncatedSnapshot_WhenLoading_ThenThrows)
+{
+  SnapshotFile file;
+
+  file.resize(SNAPSHOT_BYTES - 1);
+  checkRejected(file.path);
+}
+
+BOOST_AUTO_TEST_CASE(GivenSnapshotWithTrailingBytes_WhenLoading_ThenThrows)
+{
+  SnapshotFile file;
+
+  file.resize(SNAPSHOT_BYTES + 1);
+  checkRejected(file.path);
+  file.resize(SNAPSHOT_BYTES + static_cast<long>(sizeof(int)));
+  checkRejected(file.path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <stdexcept>
+
+#include "Vector.h"
+
+namespace
+{
+
+// Element whose copies start throwing once copiesLeft runs out. live
+// counts the objects alive, so a vector that loses track of constructed
+// elements shows up as a mismatch with getSize().
+struct FlakyCopy
+{
+  static int live;
+  static int copiesLeft;
+  int value;
+
+  explicit FlakyCopy(int v) : value(v)
+  {
+    ++live;
+  }
+
+  FlakyCopy(const FlakyCopy& other) : value(other.value)
+  {
+    if (copiesLeft-- == 0)
+      throw std::runtime_error("copy failed");
+    ++live;
+  }
+
+  FlakyCopy(FlakyCopy&& other) noexcept : value(other.value)
+  {
+    ++live;
+  }
+
+  FlakyCopy& operator=(const FlakyCopy& other)
+  {
+    if (copiesLeft-- == 0)
+      throw std::runtime_error("copy failed");
+    value = other.value;
+    return *this;
+  }
+
+  FlakyCopy& operator=(FlakyCopy&& other) noexcept
+  {
+    value = other.value;
+    return *this;
+  }
+
+  ~FlakyCopy()
+  {
+    --live;
+  }
+};
+
+int FlakyCopy::live = 0;
+int FlakyCopy::copiesLeft = 0;
+
+// std::allocator with one word of state, so it cannot be an empty base.
+template <typename Type>
+struct TaggedAllocator : std::allocator<Type>
+{
+  template <typename Other>
+  struct rebind
+  {
+    using other = TaggedAllocator<Other>;
+  };
+
+  void *tag = nullptr;
+
+  TaggedAllocator() = default;
+
+  template <typename Other>
+  TaggedAllocator(const TaggedAllocator<Other>& other) : tag(other.tag)
+  {}
+};
+
+// Inserts count copies in place at index 2 of a vector of size elements,
+// the copy number copiesAllowed + 1 throws.
+void checkInsertRollback(int size, int count, int copiesAllowed)
+{
+  {
+    aisdi::Vector<FlakyCopy> collection;
+    aisdi::Vector<FlakyCopy> items;
+
+    collection.reserve(size + count);
+    for (int i = 0; i < size; ++i)
+      collection.append(FlakyCopy(i));
+    for (int i = 0; i < count; ++i)
+      items.append(FlakyCopy(100 + i));
+
+    FlakyCopy::copiesLeft = copiesAllowed;
+    BOOST_CHECK_THROW(collection.insert(collection.begin() + 2, items.begin(), items.end()), std::runtime_error);
+    FlakyCopy::copiesLeft = 0;
+
+    std::size_t visited = 0;
+    for (auto it = collection.begin(); it != collection.end(); ++it)
+      ++visited;
+
+    BOOST_CHECK_EQUAL(visited, collection.getSize());
+    BOOST_CHECK_EQUAL(FlakyCopy::live, static_cast<int>(collection.getSize() + items.getSize()));
+  }
+  BOOST_CHECK_EQUAL(FlakyCopy::live, 0);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(VectorTests)
+
+BOOST_AUTO_TEST_CASE(GivenThrowingCopy_WhenInsertingBeforeLongerTail_ThenSizeMatchesLiveElements)
+{
+  checkInsertRollback(10, 2, 1);
+}
+
+BOOST_AUTO_TEST_CASE(GivenThrowingCopy_WhenConstructingPastTheEnd_ThenSizeMatchesLiveElements)
+{
+  checkInsertRollback(4, 6, 2);
+}
+
+BOOST_AUTO_TEST_CASE(GivenThrowingCopy_WhenAssigningAfterSpill_ThenSizeMatchesLiveElements)
+{
+  checkInsertRollback(4, 6, 5);
+}
+
+BOOST_AUTO_TEST_CASE(GivenEmptyAllocator_ThenItTakesNoRoom)
+{
+  BOOST_CHECK_EQUAL(sizeof(aisdi::Vector<int>) + sizeof(void*), sizeof(aisdi::Vector<int, TaggedAllocator<int>>));
+}
+
+BOOST_AUTO_TEST_SUITE_END()